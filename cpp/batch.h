@@ -0,0 +1,47 @@
+/**
+ * @file batch.h
+ * @brief Batch validation and classification kernels behind pandigital.h
+ *
+ * Validation splits every value as hi * 100000 + lo with a magic-number
+ * divide and folds the digits of both halves into a digit mask, as the
+ * search kernels do for their products; a value is pandigital when it has
+ * exactly 9 (10) digits and the mask is 0x3FE (0x3FF). Nine digits and
+ * nine distinct mask bits already exclude repeats, so no duplicate check
+ * is needed. 64-bit values below 2^34 are split with ((v >> 5) / 3125),
+ * which keeps the divide in 32-bit lanes; larger values have too many
+ * digits for either digit set.
+ *
+ * Classification computes the prefixes v / 10^j once and then, for every
+ * length L of k, checks that the digits after k*1 || ... || k*(n-1) are
+ * exactly k*n. The prefixes are gathered per lane, and the segment test
+ * prefix(t + d) - prefix(t) * 10^d == k*n is exact in 32-bit arithmetic
+ * because the true difference is below 10^d.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "pandigital.h"
+
+namespace impl::batch {
+    constexpr uint32_t MASK_1_9 = 0x3FE;
+    constexpr uint32_t MASK_0_9 = 0x3FF;
+    constexpr uint64_t MAX_SPLIT = uint64_t{1} << 34;   ///< 64-bit values at or above are never pandigital
+
+    namespace scalar {
+        void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero);
+        void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero);
+        void classify(const uint32_t* values, size_t count, pandigital::Product* out);
+    }
+    namespace avx2 {
+        void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero);
+        void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero);
+        void classify(const uint32_t* values, size_t count, pandigital::Product* out);
+    }
+    namespace avx512 {
+        void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero);
+        void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero);
+        void classify(const uint32_t* values, size_t count, pandigital::Product* out);
+    }
+}
@@ -0,0 +1,348 @@
+/**
+ * @file benchmark.cpp
+ * @brief Sampling, statistics and table/JSON/CSV reporting
+ *
+ * Sampling procedure per implementation:
+ * 1. `warmup` untimed calls (page faults, table builds, frequency ramp-up)
+ * 2. Calibration: double the calls per sample until one sample lasts
+ *    at least `minSampleUs`
+ * 3. `iterations` timed samples on std::chrono::steady_clock
+ * 4. Optionally, an untimed pass with hardware counters enabled, so the
+ *    counter syscalls never land inside a timed sample
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include "benchmark.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace bench {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        bool sameResult(const impl::CalcResult& a, const impl::CalcResult& b) {
+            return a.maxVal == b.maxVal && a.bestK == b.bestK && a.bestN == b.bestN;
+        }
+
+        // Nearest-rank percentile of sorted values
+        double percentile(const std::vector<double>& sorted, double p) {
+            if (sorted.empty()) return 0;
+            size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+            rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+            return sorted[rank - 1];
+        }
+
+        std::string jsonEscape(const std::string& s) {
+            std::string out;
+            for (char c : s) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out;
+        }
+
+        std::string csvField(const std::string& s) {
+            if (s.find_first_of(",\"") == std::string::npos) return s;
+            std::string out = "\"";
+            for (char c : s) {
+                if (c == '"') out += '"';
+                out += c;
+            }
+            return out + "\"";
+        }
+
+        bool anyCounters(const std::vector<Measurement>& rows) {
+            for (const auto& m : rows) {
+                if (m.counters.any()) return true;
+            }
+            return false;
+        }
+
+        const char* formatName(Format f) {
+            switch (f) {
+                case Format::Json: return "json";
+                case Format::Csv: return "csv";
+                default: return "table";
+            }
+        }
+    }
+
+    Stats summarize(std::vector<double> samplesNs, uint64_t candidates) {
+        Stats s;
+        s.samples = samplesNs.size();
+        if (samplesNs.empty()) return s;
+
+        std::sort(samplesNs.begin(), samplesNs.end());
+        s.minNs = samplesNs.front();
+        s.medianNs = percentile(samplesNs, 50);
+        s.p90Ns = percentile(samplesNs, 90);
+        s.p99Ns = percentile(samplesNs, 99);
+
+        // Tukey fence on the slow side: preemption and interrupts only add time
+        double q1 = percentile(samplesNs, 25);
+        double q3 = percentile(samplesNs, 75);
+        double fence = q3 + 3.0 * (q3 - q1);
+
+        double sum = 0;
+        size_t kept = 0;
+        for (double v : samplesNs) {
+            if (v > fence) continue;
+            sum += v;
+            ++kept;
+        }
+        s.outliers = s.samples - kept;
+        s.meanNs = sum / kept;
+
+        double var = 0;
+        for (double v : samplesNs) {
+            if (v > fence) continue;
+            var += (v - s.meanNs) * (v - s.meanNs);
+        }
+        s.stddevNs = kept > 1 ? std::sqrt(var / (kept - 1)) : 0;
+
+        if (candidates > 0 && s.medianNs > 0) {
+            s.nsPerCandidate = s.medianNs / static_cast<double>(candidates);
+            s.candidatesPerSec = static_cast<double>(candidates) * 1e9 / s.medianNs;
+        }
+        return s;
+    }
+
+    Measurement run(const std::string& name, const std::function<impl::CalcResult()>& fn,
+                    uint64_t candidates, const Config& config, perf::CounterSet* counters) {
+        Measurement m{name, fn(), true, candidates, {}, {}};
+
+        for (int i = 0; i < config.warmup; ++i) {
+            if (!sameResult(fn(), m.result)) m.consistent = false;
+        }
+
+        // Calibrate calls per sample so clock resolution is negligible
+        int calls = 1;
+        const double minSampleNs = config.minSampleUs * 1000.0;
+        for (;;) {
+            auto start = Clock::now();
+            for (int c = 0; c < calls; ++c) {
+                if (!sameResult(fn(), m.result)) m.consistent = false;
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            if (ns >= minSampleNs || calls >= (1 << 20)) break;
+            calls *= 2;
+        }
+
+        std::vector<double> samples;
+        samples.reserve(config.iterations);
+        for (int i = 0; i < config.iterations; ++i) {
+            auto start = Clock::now();
+            for (int c = 0; c < calls; ++c) {
+                if (!sameResult(fn(), m.result)) m.consistent = false;
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            samples.push_back(ns / calls);
+        }
+
+        m.stats = summarize(std::move(samples), candidates);
+        m.stats.callsPerSample = calls;
+
+        if (counters && counters->usable()) {
+            m.counters = counters->measure([&] {
+                if (!sameResult(fn(), m.result)) m.consistent = false;
+            }, static_cast<uint64_t>(calls) * 4);
+        }
+        return m;
+    }
+
+    bool pinToCpu(int cpu) {
+        if (cpu < 0) return false;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+        return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool parseFormat(const std::string& text, Format& format) {
+        if (text == "table") format = Format::Table;
+        else if (text == "json") format = Format::Json;
+        else if (text == "csv") format = Format::Csv;
+        else return false;
+        return true;
+    }
+
+    void printTable(std::ostream& out, const std::vector<Measurement>& rows) {
+        const int width = 112;
+        out << std::setfill('-') << std::setw(width) << "-" << std::endl;
+        out << std::setfill(' ')
+            << std::left << std::setw(20) << "Implementation"
+            << std::right << std::setw(12) << "Max Value"
+            << std::setw(7) << "Best K"
+            << std::setw(7) << "Best N"
+            << std::setw(11) << "Min (us)"
+            << std::setw(12) << "Median (us)"
+            << std::setw(10) << "p99 (us)"
+            << std::setw(10) << "Stddev %"
+            << std::setw(9) << "ns/k"
+            << std::setw(8) << "Outl."
+            << std::setw(6) << "Valid" << std::endl;
+        out << std::setfill('-') << std::setw(width) << "-" << std::endl;
+        out << std::setfill(' ');
+
+        for (const auto& m : rows) {
+            const Stats& s = m.stats;
+            double rel = s.meanNs > 0 ? 100.0 * s.stddevNs / s.meanNs : 0;
+            out << std::left << std::setw(20) << m.name
+                << std::right << std::setw(12) << m.result.maxVal
+                << std::setw(7) << m.result.bestK
+                << std::setw(7) << m.result.bestN
+                << std::fixed << std::setprecision(3)
+                << std::setw(11) << s.minNs / 1000.0
+                << std::setw(12) << s.medianNs / 1000.0
+                << std::setw(10) << s.p99Ns / 1000.0
+                << std::setprecision(1)
+                << std::setw(10) << rel
+                << std::setprecision(2)
+                << std::setw(9) << s.nsPerCandidate
+                << std::setw(8) << s.outliers
+                << std::setw(6) << (m.consistent ? "Yes" : "No") << std::endl;
+        }
+
+        out << std::setfill('-') << std::setw(width) << "-" << std::endl;
+        out << std::setfill(' ');
+
+        if (!anyCounters(rows)) return;
+
+        out << "\nHardware counters (per k candidate, calling thread only):\n";
+        const int perfWidth = 84;
+        out << std::setfill('-') << std::setw(perfWidth) << "-" << std::endl;
+        out << std::setfill(' ')
+            << std::left << std::setw(20) << "Implementation"
+            << std::right << std::setw(10) << "cycles"
+            << std::setw(10) << "instr"
+            << std::setw(8) << "IPC"
+            << std::setw(12) << "br-miss"
+            << std::setw(12) << "L1D-miss"
+            << std::setw(12) << "uops" << std::endl;
+        out << std::setfill('-') << std::setw(perfWidth) << "-" << std::endl;
+        out << std::setfill(' ');
+        auto cell = [&](const perf::Counts& c, perf::Event e, uint64_t candidates, int w, int prec) {
+            if (c.available[e]) {
+                out << std::setw(w) << std::setprecision(prec) << c.perCandidate(e, candidates);
+            } else {
+                out << std::setw(w) << "n/a";
+            }
+        };
+        for (const auto& m : rows) {
+            const perf::Counts& c = m.counters;
+            out << std::left << std::setw(20) << m.name << std::right << std::fixed;
+            cell(c, perf::CYCLES, m.candidates, 10, 2);
+            cell(c, perf::INSTRUCTIONS, m.candidates, 10, 2);
+            if (c.ipc() > 0) out << std::setw(8) << std::setprecision(2) << c.ipc();
+            else out << std::setw(8) << "n/a";
+            cell(c, perf::BRANCH_MISSES, m.candidates, 12, 4);
+            cell(c, perf::L1D_MISSES, m.candidates, 12, 4);
+            cell(c, perf::UOPS, m.candidates, 12, 2);
+            out << std::endl;
+        }
+        out << std::setfill('-') << std::setw(perfWidth) << "-" << std::endl;
+        out << std::setfill(' ');
+    }
+
+    void printJson(std::ostream& out, const HostInfo& host, const Config& config,
+                   const std::vector<Measurement>& rows) {
+        out << std::setprecision(6) << std::fixed;
+        out << "{\n";
+        out << "  \"host\": {\"cpu\": \"" << jsonEscape(host.cpu)
+            << "\", \"features\": \"" << jsonEscape(host.features)
+            << "\", \"dispatched\": \"" << jsonEscape(host.dispatched)
+            << "\", \"threads\": " << host.threads << "},\n";
+        out << "  \"config\": {\"warmup\": " << config.warmup
+            << ", \"iterations\": " << config.iterations
+            << ", \"min_sample_us\": " << config.minSampleUs
+            << ", \"pin_cpu\": " << config.pinCpu
+            << ", \"perf\": " << (config.perf ? "true" : "false")
+            << ", \"format\": \"" << formatName(config.format) << "\"},\n";
+        out << "  \"results\": [";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const Measurement& m = rows[i];
+            const Stats& s = m.stats;
+            out << (i ? ",\n" : "\n")
+                << "    {\"name\": \"" << jsonEscape(m.name) << "\""
+                << ", \"max_value\": " << m.result.maxVal
+                << ", \"best_k\": " << m.result.bestK
+                << ", \"best_n\": " << m.result.bestN
+                << ", \"valid\": " << (m.consistent ? "true" : "false")
+                << ", \"candidates\": " << m.candidates
+                << ", \"samples\": " << s.samples
+                << ", \"calls_per_sample\": " << s.callsPerSample
+                << ", \"outliers\": " << s.outliers
+                << ", \"min_ns\": " << s.minNs
+                << ", \"median_ns\": " << s.medianNs
+                << ", \"p90_ns\": " << s.p90Ns
+                << ", \"p99_ns\": " << s.p99Ns
+                << ", \"mean_ns\": " << s.meanNs
+                << ", \"stddev_ns\": " << s.stddevNs
+                << ", \"ns_per_candidate\": " << s.nsPerCandidate
+                << ", \"candidates_per_sec\": " << s.candidatesPerSec;
+            if (m.counters.any()) {
+                out << ", \"perf\": {\"calls\": " << m.counters.calls;
+                for (int e = 0; e < perf::EVENT_COUNT; ++e) {
+                    if (!m.counters.available[e]) continue;
+                    out << ", \"" << perf::eventName(static_cast<perf::Event>(e)) << "\": "
+                        << m.counters.value[e];
+                }
+                out << ", \"ipc\": " << m.counters.ipc() << "}";
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}" << std::endl;
+    }
+
+    void printCsv(std::ostream& out, const HostInfo& host, const std::vector<Measurement>& rows) {
+        out << std::setprecision(6) << std::fixed;
+        const bool withPerf = anyCounters(rows);
+        out << "cpu,implementation,max_value,best_k,best_n,valid,candidates,samples,"
+               "calls_per_sample,outliers,min_ns,median_ns,p90_ns,p99_ns,mean_ns,stddev_ns,"
+               "ns_per_candidate,candidates_per_sec";
+        if (withPerf) {
+            for (int e = 0; e < perf::EVENT_COUNT; ++e) {
+                out << ',' << perf::eventName(static_cast<perf::Event>(e)) << "_per_candidate";
+            }
+            out << ",ipc";
+        }
+        out << '\n';
+        for (const auto& m : rows) {
+            const Stats& s = m.stats;
+            out << csvField(host.cpu) << ',' << csvField(m.name) << ','
+                << m.result.maxVal << ',' << m.result.bestK << ',' << m.result.bestN << ','
+                << (m.consistent ? 1 : 0) << ',' << m.candidates << ','
+                << s.samples << ',' << s.callsPerSample << ',' << s.outliers << ','
+                << s.minNs << ',' << s.medianNs << ',' << s.p90Ns << ',' << s.p99Ns << ','
+                << s.meanNs << ',' << s.stddevNs << ','
+                << s.nsPerCandidate << ',' << s.candidatesPerSec;
+            if (withPerf) {
+                // Missing events stay empty rather than 0
+                for (int e = 0; e < perf::EVENT_COUNT; ++e) {
+                    out << ',';
+                    if (m.counters.available[e]) {
+                        out << m.counters.perCandidate(static_cast<perf::Event>(e), m.candidates);
+                    }
+                }
+                out << ',' << m.counters.ipc();
+            }
+            out << '\n';
+        }
+        out.flush();
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file benchmark.h
+ * @brief Benchmark harness with warmup, robust statistics and reporters
+ *
+ * Kernels finish in microseconds, so every sample times a calibrated
+ * number of back-to-back calls and reports the per-call time. Samples
+ * beyond the Tukey fence (Q3 + 3 * IQR) are counted as outliers and left
+ * out of the mean and standard deviation; the percentiles use all samples.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "calc_result.h"
+#include "perf_counters.h"
+
+namespace bench {
+    enum class Format { Table, Json, Csv };
+
+    /**
+     * @struct Config
+     * @brief Harness settings (see main.cpp for the matching flags)
+     */
+    struct Config {
+        int warmup = 3;                ///< Untimed calls before sampling
+        int iterations = 50;           ///< Timed samples per implementation
+        double minSampleUs = 200.0;    ///< Each sample repeats calls until it lasts this long
+        int pinCpu = -1;               ///< CPU to pin the calling thread to, -1 to leave unpinned
+        bool perf = false;             ///< Read hardware counters in a separate pass
+        Format format = Format::Table;
+    };
+
+    /**
+     * @struct Stats
+     * @brief Per-call timing statistics of one implementation
+     */
+    struct Stats {
+        size_t samples = 0;
+        int callsPerSample = 1;
+        size_t outliers = 0;
+        double minNs = 0;
+        double medianNs = 0;
+        double p90Ns = 0;
+        double p99Ns = 0;
+        double meanNs = 0;              ///< Without outliers
+        double stddevNs = 0;            ///< Without outliers
+        double nsPerCandidate = 0;      ///< medianNs / candidates
+        double candidatesPerSec = 0;    ///< candidates / median
+    };
+
+    /**
+     * @struct Measurement
+     * @brief Result row for one implementation
+     */
+    struct Measurement {
+        std::string name;
+        impl::CalcResult result;
+        bool consistent;                ///< Every call returned the same result
+        uint64_t candidates;            ///< k values searched per call
+        Stats stats;
+        perf::Counts counters;          ///< Empty unless Config::perf
+    };
+
+    /// Host description written alongside the results
+    struct HostInfo {
+        std::string cpu;
+        std::string features;
+        std::string dispatched;
+        unsigned threads;
+    };
+
+    /**
+     * @brief Times fn according to config
+     * @param name Display name
+     * @param fn Implementation under test
+     * @param candidates Number of k values fn searches per call
+     * @param counters Hardware counters read after the timed samples
+     *                 (nullptr to skip). Only the calling thread is counted.
+     */
+    Measurement run(const std::string& name, const std::function<impl::CalcResult()>& fn,
+                    uint64_t candidates, const Config& config,
+                    perf::CounterSet* counters = nullptr);
+
+    /// Computes statistics from per-call sample times in nanoseconds
+    Stats summarize(std::vector<double> samplesNs, uint64_t candidates);
+
+    /// Pins the calling thread to cpu; returns false if unsupported or refused
+    bool pinToCpu(int cpu);
+
+    /// Parses "table", "json" or "csv"; returns false for anything else
+    bool parseFormat(const std::string& text, Format& format);
+
+    void printTable(std::ostream& out, const std::vector<Measurement>& rows);
+    void printJson(std::ostream& out, const HostInfo& host, const Config& config,
+                   const std::vector<Measurement>& rows);
+    void printCsv(std::ostream& out, const HostInfo& host, const std::vector<Measurement>& rows);
+}
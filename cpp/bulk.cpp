@@ -0,0 +1,169 @@
+/**
+ * @file bulk.cpp
+ * @brief Chunking, scanner selection and output for bulk validation
+ *
+ * Compiled without ISA flags, like dispatch.cpp: the text scanner is
+ * picked from the CPU features and binary records use the dispatched
+ * pandigital::validate_batch.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "bulk.h"
+#include "cpu_features.h"
+#include "pandigital.h"
+
+namespace impl::bulk {
+    namespace {
+        using TextScanner = uint64_t (*)(const char*, size_t, size_t, size_t, bool, OffsetBuffer&);
+
+        struct Scanner {
+            TextScanner scan;
+            const char* name;
+        };
+
+        const Scanner& scanner() {
+            static const Scanner chosen = cpu::features().avx2 ? Scanner{avx2::scanText, "AVX2"}
+                                                               : Scanner{scalar::scanText, "Scalar"};
+            return chosen;
+        }
+
+        size_t recordSize(Input input) {
+            switch (input) {
+                case Input::U32: return sizeof(uint32_t);
+                case Input::U64: return sizeof(uint64_t);
+                default: return 1;
+            }
+        }
+
+        // First line start at or after pos
+        size_t lineStart(const char* data, size_t size, size_t pos) {
+            if (pos == 0) return 0;
+            const void* nl = std::memchr(data + pos - 1, '\n', size - (pos - 1));
+            return nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) + 1 : size;
+        }
+
+        // Records [first, last) straight from the mapping
+        template <typename T>
+        void scanRecords(const char* data, size_t first, size_t last, bool zero, OffsetBuffer& out) {
+            constexpr size_t BLOCK = 4096;
+            uint8_t flags[BLOCK];
+            const T* records = reinterpret_cast<const T*>(data);
+            const auto digits = zero ? pandigital::Digits::ZeroToNine : pandigital::Digits::OneToNine;
+            for (size_t i = first; i < last; i += BLOCK) {
+                const size_t count = std::min(BLOCK, last - i);
+                pandigital::validate_batch(records + i, count, flags, digits);
+                for (size_t j = 0; j < count; ++j) {
+                    if (flags[j]) out.push((i + j) * sizeof(T));
+                }
+            }
+        }
+    }
+
+    bool parseInput(const char* name, Input& out) {
+        if (std::strcmp(name, "text") == 0) {
+            out = Input::Text;
+        } else if (std::strcmp(name, "u32") == 0) {
+            out = Input::U32;
+        } else if (std::strcmp(name, "u64") == 0) {
+            out = Input::U64;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    Stats run(parallel::ThreadPool& pool, const char* data, size_t size,
+              const Options& options, const Sink& sink) {
+        Stats stats;
+        stats.kernel = options.input == Input::Text ? scanner().name : pandigital::kernel_name();
+
+        // Chunks are counted in records so binary chunks never split one
+        const size_t record = recordSize(options.input);
+        const size_t records = size / record;   // A trailing partial record is ignored
+        const size_t perChunk = std::max<size_t>(options.chunkBytes / record, 1);
+        const size_t chunks = (records + perChunk - 1) / perChunk;
+        const size_t lineBytes = options.zero ? 10 : 9;
+
+        std::mutex outputMutex;
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> lines{0};
+        std::atomic<uint64_t> matches{0};
+
+        pool.run([&](unsigned) {
+            // Offsets are encoded little-endian into a block allocated once per
+            // worker; values are written straight from the mapping, one sink
+            // call per run of adjacent matches
+            std::vector<char> block(options.offsets ? OffsetBuffer::CAPACITY * sizeof(uint64_t) : 0);
+            OffsetBuffer buffer([&](const uint64_t* offsets, size_t count) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (options.offsets) {
+                    char* p = block.data();
+                    for (size_t i = 0; i < count; ++i) {
+                        for (size_t b = 0; b < sizeof(uint64_t); ++b) *p++ = static_cast<char>(offsets[i] >> (8 * b));
+                    }
+                    sink(block.data(), static_cast<size_t>(p - block.data()));
+                    return;
+                }
+                if (options.input != Input::Text) {
+                    for (size_t i = 0; i < count;) {
+                        size_t j = i + 1;
+                        while (j < count && offsets[j] == offsets[j - 1] + record) ++j;
+                        sink(data + offsets[i], static_cast<size_t>(offsets[j - 1] + record - offsets[i]));
+                        i = j;
+                    }
+                    return;
+                }
+                // A matched line followed directly by '\n' is written with it;
+                // '\r' and a missing last newline end the run
+                auto plainEnd = [&](uint64_t offset) {
+                    return offset + lineBytes < size && data[offset + lineBytes] == '\n';
+                };
+                for (size_t i = 0; i < count;) {
+                    size_t j = i + 1;
+                    while (j < count && plainEnd(offsets[j - 1]) && offsets[j] == offsets[j - 1] + lineBytes + 1) ++j;
+                    const uint64_t last = offsets[j - 1];
+                    if (plainEnd(last)) {
+                        sink(data + offsets[i], static_cast<size_t>(last + lineBytes + 1 - offsets[i]));
+                    } else {
+                        sink(data + offsets[i], static_cast<size_t>(last + lineBytes - offsets[i]));
+                        sink("\n", 1);
+                    }
+                    i = j;
+                }
+            });
+
+            uint64_t seen = 0;
+            for (size_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+                 c = next.fetch_add(1, std::memory_order_relaxed)) {
+                const size_t first = c * perChunk;
+                const size_t last = std::min(records, first + perChunk);
+                switch (options.input) {
+                    case Input::U32:
+                        scanRecords<uint32_t>(data, first, last, options.zero, buffer);
+                        seen += last - first;
+                        break;
+                    case Input::U64:
+                        scanRecords<uint64_t>(data, first, last, options.zero, buffer);
+                        seen += last - first;
+                        break;
+                    default: {
+                        // Lines belong to the chunk holding their first byte
+                        const size_t begin = lineStart(data, size, first);
+                        if (begin < last) seen += scanner().scan(data, size, begin, last, options.zero, buffer);
+                        break;
+                    }
+                }
+            }
+            buffer.flush();
+            lines.fetch_add(seen, std::memory_order_relaxed);
+            matches.fetch_add(buffer.appended(), std::memory_order_relaxed);
+        });
+
+        stats.records = lines.load();
+        stats.matches = matches.load();
+        return stats;
+    }
+}
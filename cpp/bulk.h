@@ -0,0 +1,112 @@
+/**
+ * @file bulk.h
+ * @brief Bulk validation of memory-mapped candidate files
+ *
+ * Input is either newline-separated ASCII (one number per line, optional
+ * '\r') or packed little-endian u32 / u64 records. The file is mapped
+ * read-only and split into chunks that the thread pool claims like k
+ * ranges in parallel.h; text chunks are aligned to line starts.
+ *
+ * Text lines are never parsed into integers: a line matches when it is
+ * exactly 9 (or 10) bytes long and each digit byte occurs in it, tested
+ * with one vpcmpeqb per digit on the 16 bytes at the line start. Binary
+ * records go straight from the mapping through pandigital::validate_batch.
+ * Matches are staged as byte offsets in a fixed per-worker OffsetBuffer and
+ * written as values (the original line or record, passed to the sink
+ * straight from the mapping) or as u64 offsets.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "parallel.h"
+
+namespace impl::bulk {
+    enum class Input { Text, U32, U64 };
+
+    /// Parses "text", "u32" or "u64"
+    bool parseInput(const char* name, Input& out);
+
+    /**
+     * @struct Options
+     * @brief What to validate and what to write per match
+     */
+    struct Options {
+        Input input = Input::Text;
+        bool zero = false;                   ///< 0-9 (10 digits) instead of 1-9
+        bool offsets = false;                ///< Write u64 byte offsets instead of values
+        size_t chunkBytes = size_t{1} << 20; ///< Bytes claimed per step
+    };
+
+    /**
+     * @struct Stats
+     * @brief Totals of one run
+     */
+    struct Stats {
+        uint64_t records = 0;    ///< Lines or records seen
+        uint64_t matches = 0;    ///< Pandigital ones
+        const char* kernel = ""; ///< Text scanner used ("AVX2" or "Scalar")
+    };
+
+    /// Receives output bytes; calls are serialized, chunks arrive in completion order
+    using Sink = std::function<void(const char* bytes, size_t length)>;
+
+    /**
+     * @class OffsetBuffer
+     * @brief Fixed-capacity staging of match offsets
+     */
+    class OffsetBuffer {
+    public:
+        static constexpr size_t CAPACITY = 4096;
+        using Flush = std::function<void(const uint64_t* offsets, size_t count)>;
+
+        explicit OffsetBuffer(Flush sink) : sink(std::move(sink)) {}
+        ~OffsetBuffer() { flush(); }
+
+        OffsetBuffer(const OffsetBuffer&) = delete;
+        OffsetBuffer& operator=(const OffsetBuffer&) = delete;
+
+        void push(uint64_t offset) {
+            offsets[used++] = offset;
+            if (used == CAPACITY) flush();
+        }
+
+        void flush() {
+            if (used == 0) return;
+            sink(offsets, used);
+            total += used;
+            used = 0;
+        }
+
+        /// Offsets pushed since construction
+        uint64_t appended() const { return total + used; }
+
+    private:
+        uint64_t offsets[CAPACITY];
+        size_t used = 0;
+        uint64_t total = 0;
+        Flush sink;
+    };
+
+    // scanText pushes the offset of every pandigital line starting in
+    // [begin, end) and returns the number of lines starting there. begin
+    // must be a line start; lines may run past end, so data[0, size) is
+    // the whole file.
+    namespace scalar {
+        uint64_t scanText(const char* data, size_t size, size_t begin, size_t end,
+                          bool zero, OffsetBuffer& out);
+    }
+    namespace avx2 {
+        uint64_t scanText(const char* data, size_t size, size_t begin, size_t end,
+                          bool zero, OffsetBuffer& out);
+    }
+
+    /**
+     * @brief Validates the mapped file data[0, size) on pool
+     * @param sink Receives the output (values or offsets)
+     */
+    Stats run(parallel::ThreadPool& pool, const char* data, size_t size,
+              const Options& options, const Sink& sink);
+}
@@ -0,0 +1,296 @@
+/**
+ * @file cache.cpp
+ * @brief Cache file I/O and the piecewise cached search
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include "cache.h"
+#include "mapped_file.h"
+
+namespace impl::cache {
+    namespace {
+        constexpr char MAGIC[8] = {'P', 'D', 'C', 'A', 'C', 'H', 'E', '1'};
+        constexpr size_t BLOCK = 64;        // header and record size
+        constexpr size_t CHECKED = 56;      // record bytes covered by the checksum
+        constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+        constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+        uint64_t fnv1a(const unsigned char* bytes, size_t length) {
+            uint64_t h = FNV_OFFSET;
+            for (size_t i = 0; i < length; ++i) {
+                h ^= bytes[i];
+                h *= FNV_PRIME;
+            }
+            return h;
+        }
+
+        void put(unsigned char*& p, uint64_t v, int bytes) {
+            for (int b = 0; b < bytes; ++b) *p++ = static_cast<unsigned char>(v >> (8 * b));
+        }
+
+        uint64_t get(const unsigned char*& p, int bytes) {
+            uint64_t v = 0;
+            for (int b = 0; b < bytes; ++b) v |= uint64_t{p[b]} << (8 * b);
+            p += bytes;
+            return v;
+        }
+
+        double since(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    Key key(int base, bool zero) {
+        Key k;
+        k.base = static_cast<uint32_t>(base);
+        k.digits = ((1u << base) - 1) & (zero ? ~0u : ~1u);
+        k.nMin = 2;
+        k.nMax = static_cast<uint32_t>(zero ? base : base - 1);
+        return k;
+    }
+
+    std::vector<Piece> pieces(uint64_t kBegin, uint64_t kEnd) {
+        std::vector<Piece> out;
+        for (uint64_t k = kBegin; k <= kEnd;) {
+            const uint64_t span = kEnd - k;   // k values left, minus one
+            uint64_t size = 0;
+            if (k % MIN_BLOCK == 0 && span >= MIN_BLOCK - 1) {
+                size = MIN_BLOCK;
+                while (size < (uint64_t{1} << 62) && k % (size * 2) == 0 && size * 2 - 1 <= span) {
+                    size *= 2;
+                }
+            }
+            // Without a block: up to the next block boundary
+            const uint64_t end = size ? k + (size - 1)
+                                      : std::min(kEnd, k + (MIN_BLOCK - 1 - k % MIN_BLOCK));
+            out.push_back({k, end});
+            if (end == kEnd) break;
+            k = end + 1;
+        }
+        return out;
+    }
+
+    size_t ResultCache::RecordHash::operator()(const Record& r) const {
+        uint64_t h = FNV_OFFSET;
+        for (uint64_t v : {uint64_t{r.key.base}, uint64_t{r.key.digits}, uint64_t{r.key.nMin},
+                           uint64_t{r.key.nMax}, r.kBegin, r.kEnd}) {
+            h = (h ^ v) * FNV_PRIME;
+            h ^= h >> 29;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    ResultCache::ResultCache(const char* file) : path(file) {
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            valid = true;
+            return;
+        }
+        io::MappedFile map(file);
+        if (!map.ok()) {
+            message = map.error();
+            return;
+        }
+        if (map.size() == 0) {
+            valid = true;
+            return;
+        }
+        const auto* bytes = reinterpret_cast<const unsigned char*>(map.data());
+        const unsigned char* h = bytes + sizeof(MAGIC);
+        if (map.size() < BLOCK || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0 || get(h, 4) != BLOCK) {
+            message = "not a result cache file";
+            return;
+        }
+
+        for (size_t offset = BLOCK; offset + BLOCK <= map.size(); offset += BLOCK) {
+            const unsigned char* p = bytes + offset;
+            const unsigned char* sum = p + CHECKED;
+            if (get(sum, 8) != fnv1a(p, CHECKED)) {
+                ++damaged;
+                continue;
+            }
+            Record r;
+            r.key.base = static_cast<uint32_t>(get(p, 4));
+            r.key.digits = static_cast<uint32_t>(get(p, 4));
+            r.key.nMin = static_cast<uint32_t>(get(p, 4));
+            r.key.nMax = static_cast<uint32_t>(get(p, 4));
+            r.kBegin = get(p, 8);
+            r.kEnd = get(p, 8);
+            stream::Result best;
+            best.maxVal = get(p, 8);
+            best.bestK = get(p, 8);
+            best.bestN = static_cast<int>(get(p, 4));
+            index.emplace(r, best);
+        }
+        if (map.size() % BLOCK != 0) ++damaged;
+        valid = true;
+    }
+
+    bool ResultCache::find(const Key& key, uint64_t kBegin, uint64_t kEnd, stream::Result& best) const {
+        auto it = index.find(Record{key, kBegin, kEnd});
+        if (it == index.end()) return false;
+        best = it->second;
+        return true;
+    }
+
+    void ResultCache::add(const Key& key, uint64_t kBegin, uint64_t kEnd, const stream::Result& best) {
+        if (!index.emplace(Record{key, kBegin, kEnd}, best).second) return;
+
+        unsigned char record[BLOCK] = {};
+        unsigned char* p = record;
+        put(p, key.base, 4);
+        put(p, key.digits, 4);
+        put(p, key.nMin, 4);
+        put(p, key.nMax, 4);
+        put(p, kBegin, 8);
+        put(p, kEnd, 8);
+        put(p, best.maxVal, 8);
+        put(p, best.bestK, 8);
+        put(p, static_cast<uint64_t>(best.bestN), 4);
+        put(p, 0, 4);
+        put(p, fnv1a(record, CHECKED), 8);
+        pending.insert(pending.end(), record, record + BLOCK);
+    }
+
+    bool ResultCache::flush() {
+        if (pending.empty()) return true;
+        if (!valid) return false;
+
+        std::FILE* file = std::fopen(path.c_str(), "ab");
+        if (!file) return false;
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+
+        // A new file gets the header; a torn tail is padded to the next
+        // block so the appended records stay aligned
+        std::vector<unsigned char> bytes;
+        if (size == 0) {
+            bytes.resize(BLOCK, 0);
+            std::memcpy(bytes.data(), MAGIC, sizeof(MAGIC));
+            unsigned char* p = bytes.data() + sizeof(MAGIC);
+            put(p, BLOCK, 4);
+        } else if (size > 0 && size % BLOCK != 0) {
+            bytes.resize(BLOCK - size % BLOCK, 0);
+        }
+        bytes.insert(bytes.end(), pending.begin(), pending.end());
+
+        bool ok = size >= 0 && std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = std::fclose(file) == 0 && ok;
+        if (ok) pending.clear();
+        return ok;
+    }
+
+    Outcome search(ResultCache& cache, parallel::ThreadPool* pool, int base, bool zero,
+                   uint64_t kBegin, uint64_t kEnd, const stream::Options& options) {
+        Outcome outcome;
+        stream::Outcome& total = outcome.search;
+        if (options.checkpoint) {
+            total.error = "checkpoints cannot be combined with the result cache";
+            return outcome;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        kBegin = std::max<uint64_t>(kBegin, 1);
+        kEnd = std::min(kEnd, stream::maxK(base, zero));
+        if (kEnd < kBegin) return outcome;
+        total.total = kEnd - kBegin + 1;
+
+        const Key key = cache::key(base, zero);
+        const std::vector<Piece> parts = pieces(kBegin, kEnd);
+        outcome.pieces = parts.size();
+
+        // Cached summaries, descending into the halves of missing blocks;
+        // what is left are leaves: MIN_BLOCK blocks and end fragments
+        std::vector<Piece> missing;
+        std::function<void(uint64_t, uint64_t)> collect = [&](uint64_t lo, uint64_t hi) {
+            stream::Result best;
+            if (cache.find(key, lo, hi, best)) {
+                stream::merge(total.result, best);
+                outcome.cached += hi - lo + 1;
+                ++outcome.hits;
+            } else if (hi - lo >= MIN_BLOCK) {
+                const uint64_t mid = lo + (hi - lo) / 2;
+                collect(lo, mid);
+                collect(mid + 1, hi);
+            } else {
+                missing.push_back({lo, hi});
+            }
+        };
+        for (const Piece& p : parts) collect(p.kBegin, p.kEnd);
+        total.searched = outcome.cached;
+
+        if (!missing.empty()) {
+            // Contiguous leaves from an aligned start form one run whose
+            // stream chunks are exactly the leaves
+            std::vector<Piece> runs;
+            for (const Piece& leaf : missing) {
+                if (!runs.empty() && runs.back().kEnd + 1 == leaf.kBegin && runs.back().kBegin % MIN_BLOCK == 0) {
+                    runs.back().kEnd = leaf.kEnd;
+                } else {
+                    runs.push_back(leaf);
+                }
+            }
+
+            parallel::ThreadPool& workers = pool ? *pool : parallel::defaultPool();
+            stream::Options run = options;
+            run.chunk = MIN_BLOCK;
+            run.onChunk = [&](uint64_t lo, uint64_t hi, const stream::Result& best) {
+                cache.add(key, lo, hi, best);
+            };
+            double nextReport = options.interval;
+            for (const Piece& r : runs) {
+                if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+                    total.cancelled = true;
+                    break;
+                }
+                // Progress of the run, shifted to the whole query
+                if (options.progress) {
+                    const uint64_t before = total.searched;
+                    const stream::Result bestBefore = total.result;
+                    run.progress = [&, before, bestBefore](const stream::Progress& rp) {
+                        stream::Progress q = rp;
+                        q.done += before;
+                        q.total = total.total;
+                        q.resumed = outcome.cached;
+                        q.seconds = since(start);
+                        stream::merge(q.best, bestBefore);
+                        if (q.seconds < nextReport && q.done < q.total) return;
+                        nextReport = q.seconds + options.interval;
+                        options.progress(q);
+                    };
+                }
+                const stream::Outcome part = stream::search(workers, base, zero, r.kBegin, r.kEnd, run);
+                stream::merge(total.result, part.result);
+                total.searched += part.searched;
+                if (part.cancelled) {
+                    total.cancelled = true;
+                    break;
+                }
+            }
+
+            // Summaries of the blocks above the new leaves
+            std::function<bool(uint64_t, uint64_t, stream::Result&)> build =
+                [&](uint64_t lo, uint64_t hi, stream::Result& best) {
+                    if (cache.find(key, lo, hi, best)) return true;
+                    if (hi - lo < MIN_BLOCK) return false;
+                    const uint64_t mid = lo + (hi - lo) / 2;
+                    stream::Result upper;
+                    if (!build(lo, mid, best) || !build(mid + 1, hi, upper)) return false;
+                    stream::merge(best, upper);
+                    cache.add(key, lo, hi, best);
+                    return true;
+                };
+            for (const Piece& p : parts) {
+                stream::Result best;
+                build(p.kBegin, p.kEnd, best);
+            }
+            outcome.writeFailed = !cache.flush();
+        }
+        total.seconds = since(start);
+        return outcome;
+    }
+}
@@ -0,0 +1,159 @@
+/**
+ * @file cache.h
+ * @brief Persistent cache of streaming-search results
+ *
+ * Every streaming search with the same base, digit set and n range
+ * produces the same best hit for the same k interval, so interval
+ * summaries can be kept across runs. A query is cut into pieces:
+ *   - aligned power-of-two blocks of at least MIN_BLOCK k values
+ *     ([j * 2^s, (j + 1) * 2^s - 1], the largest that fit), and
+ *   - the unaligned fragments at either end.
+ * A block missing from the cache is looked up as its two halves, down to
+ * MIN_BLOCK; the leaves still missing are searched with stream::search
+ * (one stream chunk per leaf), and the summaries of every new leaf and of
+ * every block above them are appended. The blocks form one tree per key,
+ * so overlapping queries share everything but their end fragments:
+ * extending [1, X] to [1, Y] searches only above X, and repeating a query
+ * searches nothing. Best hits are merged with stream::merge, so the answer
+ * equals an uncached search of the whole interval.
+ *
+ * Only the best hit is summarized: it is the one summary that the
+ * 64-bit engine computes and that can be merged across pieces. Top-K
+ * and enumeration run on the base-10 engines, whose whole range takes
+ * microseconds.
+ *
+ * File layout (little-endian, 64-byte blocks, read through MappedFile):
+ *   header: magic "PDCACHE1", u32 record size (64), zero padding
+ *   record: u32 base, u32 digit mask, u32 nMin, u32 nMax, u64 kBegin,
+ *           u64 kEnd, u64 maxVal, u64 bestK, u32 bestN, u32 reserved,
+ *           u64 FNV-1a checksum of the first 56 bytes
+ * New records are appended in one write. A torn tail, or a header that a
+ * concurrent first writer appended twice, fails the record checksum and
+ * is skipped; losing a record only costs recomputing its piece.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "stream.h"
+
+namespace impl::cache {
+    /// Smallest cached block (16 default stream chunks); queries can
+    /// reuse everything but the up to 2 * MIN_BLOCK k values at their ends
+    constexpr uint64_t MIN_BLOCK = uint64_t{1} << 20;
+
+    /**
+     * @struct Key
+     * @brief Search parameters that determine a summary besides the k interval
+     */
+    struct Key {
+        uint32_t base = 10;
+        uint32_t digits = 0;    ///< Digit set as a bit mask (bit d for digit d)
+        uint32_t nMin = 2;      ///< Smallest n of k*1 || ... || k*n
+        uint32_t nMax = 9;      ///< Largest n
+
+        bool operator==(const Key& o) const {
+            return base == o.base && digits == o.digits && nMin == o.nMin && nMax == o.nMax;
+        }
+    };
+
+    /// Key of the streaming search of base in the given mode (all n >= 2)
+    Key key(int base, bool zero);
+
+    /**
+     * @struct Piece
+     * @brief One cacheable interval of a query
+     */
+    struct Piece {
+        uint64_t kBegin;
+        uint64_t kEnd;
+    };
+
+    /// Cuts [kBegin, kEnd] into aligned blocks and end fragments, ascending
+    std::vector<Piece> pieces(uint64_t kBegin, uint64_t kEnd);
+
+    /**
+     * @class ResultCache
+     * @brief In-memory index of a cache file plus the records to append
+     *
+     * The constructor maps the file, indexes every valid record and
+     * releases the mapping again, so the file can be appended to while
+     * the index is in use (also on Windows).
+     */
+    class ResultCache {
+    public:
+        /// Loads path; a missing file is an empty cache
+        explicit ResultCache(const char* path);
+
+        /// false if path exists but is not a cache file (it is never overwritten)
+        bool ok() const { return valid; }
+        const std::string& error() const { return message; }
+
+        /// Number of indexed records
+        size_t size() const { return index.size(); }
+
+        /// Records that failed their checksum
+        size_t skipped() const { return damaged; }
+
+        /// Summary of exactly [kBegin, kEnd] under key
+        bool find(const Key& key, uint64_t kBegin, uint64_t kEnd, stream::Result& best) const;
+
+        /// Adds a summary; written by flush()
+        void add(const Key& key, uint64_t kBegin, uint64_t kEnd, const stream::Result& best);
+
+        /// Appends the records added since the last flush; false on I/O errors
+        bool flush();
+
+    private:
+        struct Record {
+            Key key;
+            uint64_t kBegin;
+            uint64_t kEnd;
+        };
+
+        struct RecordHash {
+            size_t operator()(const Record& r) const;
+        };
+
+        struct RecordEqual {
+            bool operator()(const Record& a, const Record& b) const {
+                return a.key == b.key && a.kBegin == b.kBegin && a.kEnd == b.kEnd;
+            }
+        };
+
+        std::string path;
+        std::unordered_map<Record, stream::Result, RecordHash, RecordEqual> index;
+        std::vector<unsigned char> pending;
+        size_t damaged = 0;
+        bool valid = false;
+        std::string message;
+    };
+
+    /**
+     * @struct Outcome
+     * @brief Result of a cached search
+     */
+    struct Outcome {
+        stream::Outcome search;     ///< Merged result; searched includes the cached k values
+        uint64_t cached = 0;        ///< k values answered from the cache
+        size_t pieces = 0;          ///< Top-level pieces of the query
+        size_t hits = 0;            ///< Cached summaries used
+        bool writeFailed = false;   ///< New summaries could not be appended
+    };
+
+    /**
+     * @brief Streaming search of [kBegin, kEnd] that reuses and extends cache
+     * @param pool Workers for the missing pieces; nullptr for
+     *             parallel::defaultPool(), which is then only created if
+     *             a piece is missing
+     * @param options As for stream::search, except checkpoint (must be
+     *                null); progress counts the whole query
+     *
+     * A cancelled search caches the pieces finished before the cancel.
+     */
+    Outcome search(ResultCache& cache, parallel::ThreadPool* pool, int base, bool zero,
+                   uint64_t kBegin, uint64_t kEnd, const stream::Options& options = {});
+}
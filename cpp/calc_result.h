@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace impl {
     /**
      * @struct CalcResult
@@ -12,11 +14,26 @@ namespace impl {
      * 
      * @member maxVal Largest pandigital number found
      * @member bestK Value of k that produces maxVal
-     * @member bestN Multiplier used (always 2 in current implementation)
+     * @member bestN Largest multiplier n in the concatenation k*1 || k*2 || ... || k*n
      */
     struct CalcResult {
-        int maxVal;  ///< Largest pandigital number found
-        int bestK;   ///< Value of k that produces maxVal
-        int bestN;   ///< Multiplier (fixed at 2)
+        uint64_t maxVal;  ///< Largest pandigital number found (64-bit for bases above 10)
+        int bestK;        ///< Value of k that produces maxVal
+        int bestN;        ///< Number of multipliers n (2..9 in base 10)
     };
-}
\ No newline at end of file
+
+    /**
+     * @brief Folds candidate into best using a deterministic total order
+     *
+     * Larger maxVal wins; ties go to the smaller k, then the smaller n, so
+     * merging partial results in any order yields the same answer.
+     */
+    constexpr void mergeMax(CalcResult& best, const CalcResult& candidate) {
+        if (candidate.maxVal > best.maxVal ||
+            (candidate.maxVal == best.maxVal && candidate.maxVal != 0 &&
+             (candidate.bestK < best.bestK ||
+              (candidate.bestK == best.bestK && candidate.bestN < best.bestN)))) {
+            best = candidate;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file check_divide.cpp
+ * @brief Runs the exhaustive division check on every instruction set the CPU has
+ *
+ * Exit code 0 if every case matches / and % on every dividend, 1 otherwise.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "check_divide.h"
+#include "cpu_features.h"
+
+namespace {
+    using DivideFn = impl::check::DivideReport (*)(size_t, uint64_t, uint64_t);
+
+    /// Splits [0, 2^bits) over the hardware threads; slices stay multiples of 16
+    impl::check::DivideReport runAll(DivideFn fn, size_t index) {
+        const uint64_t total = uint64_t{1} << impl::check::DIVIDE_CASES.cases[index].bits;
+        const unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+        const uint64_t slice = ((total / threads + 15) / 16) * 16;
+
+        std::vector<impl::check::DivideReport> reports(threads);
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            const uint64_t begin = std::min(total, t * slice);
+            const uint64_t end = std::min(total, begin + slice);
+            workers.emplace_back([&, t, begin, end] { reports[t] = fn(index, begin, end); });
+        }
+        for (std::thread& w : workers) w.join();
+
+        impl::check::DivideReport all;
+        for (const impl::check::DivideReport& r : reports) {
+            if (r.mismatches > 0 && (all.mismatches == 0 || r.first < all.first)) all.first = r.first;
+            all.mismatches += r.mismatches;
+        }
+        return all;
+    }
+}
+
+int main() {
+    const impl::cpu::CpuFeatures& features = impl::cpu::features();
+    struct Isa {
+        const char* name;
+        bool supported;
+        DivideFn fn;
+    };
+    const Isa isas[] = {
+        {"AVX2", features.avx2, impl::check::avx2::divide},
+        {"AVX-512", features.avx512f && features.avx512dq && features.avx512bw && features.avx512vl,
+         impl::check::avx512::divide},
+    };
+
+    bool ok = true;
+    for (const Isa& isa : isas) {
+        if (!isa.supported) {
+            std::cout << isa.name << ": not supported by this CPU, skipped" << std::endl;
+            continue;
+        }
+        for (size_t i = 0; i < impl::check::DIVIDE_CASE_COUNT; ++i) {
+            const impl::check::DivideCase& c = impl::check::DIVIDE_CASES.cases[i];
+            const auto start = std::chrono::steady_clock::now();
+            const impl::check::DivideReport r = runAll(isa.fn, i);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << isa.name << ": x / " << c.divisor << " and x % " << c.divisor << " for x < 2^" << c.bits
+                      << ": " << r.mismatches << " mismatches";
+            if (r.mismatches > 0) std::cout << " (first at x = " << r.first << ")";
+            std::cout << " (" << std::fixed << std::setprecision(1) << seconds << " s)" << std::endl;
+            ok = ok && r.mismatches == 0;
+        }
+    }
+    std::cout << (ok ? "All divisions exact" : "Division mismatches found") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file check_divide.h
+ * @brief Exhaustive check of the vector division in simd_divide.h
+ *
+ * Every divisor and dividend width the kernels instantiate is run over all
+ * 2^Bits dividends and compared lane by lane with the scalar / and %. The
+ * lane code lives in check_divide_simd.cpp, which is built once per
+ * instruction set; check_divide.cpp (no ISA flags) picks the sets the CPU
+ * supports. Not part of the default build:
+ *   cmake --build build --target check_divide && ./build/check_divide
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "radix.h"
+
+namespace impl::check {
+    /**
+     * @struct DivideCase
+     * @brief One DivMagic instantiation: x / divisor for x < 2^bits
+     */
+    struct DivideCase {
+        uint32_t divisor;
+        unsigned bits;
+    };
+
+    /**
+     * @struct DivideCaseList
+     * @brief Distinct cases, filled at compile time
+     */
+    struct DivideCaseList {
+        DivideCase cases[64] = {};
+        size_t count = 0;
+
+        constexpr void add(uint32_t divisor, unsigned bits) {
+            for (size_t i = 0; i < count; ++i) {
+                if (cases[i].divisor == divisor && cases[i].bits == bits) return;
+            }
+            cases[count++] = {divisor, bits};
+        }
+    };
+
+    namespace detail {
+        // x / Base over the products of the base-Base engines (radix kernels'
+        // div_epu32<R::BASE, R::P_BITS>; powers of two are shifts)
+        template <int Base>
+        constexpr void addRadix(DivideCaseList& list) {
+            if constexpr ((Base & (Base - 1)) != 0) {
+                list.add(Base, radix::Radix<Base, false>::P_BITS);
+                if constexpr (Base <= radix::MAX_ZERO_BASE) list.add(Base, radix::Radix<Base, true>::P_BITS);
+            }
+        }
+
+        template <int... Offsets>
+        constexpr void addRadixBases(DivideCaseList& list, std::integer_sequence<int, Offsets...>) {
+            (addRadix<radix::MIN_BASE + Offsets>(list), ...);
+        }
+
+        constexpr DivideCaseList makeDivideCases() {
+            DivideCaseList list;
+            // simd_divide.h's named helpers (div10/100/10000_epu32)
+            list.add(10, 32);
+            list.add(100, 32);
+            list.add(10000, 32);
+            // v / 100000 as (v >> 5) / 3125 in the batch kernels (u32 and u64 inputs)
+            list.add(3125, 27);
+            list.add(3125, 29);
+            addRadixBases(list, std::make_integer_sequence<int, radix::MAX_BASE - radix::MIN_BASE + 1>{});
+            return list;
+        }
+    }
+
+    /// Every div_epu32 instantiation of the kernels
+    constexpr DivideCaseList DIVIDE_CASES = detail::makeDivideCases();
+    constexpr size_t DIVIDE_CASE_COUNT = DIVIDE_CASES.count;
+
+    /**
+     * @struct DivideReport
+     * @brief Mismatches of one case over a dividend interval
+     */
+    struct DivideReport {
+        uint64_t mismatches = 0;
+        uint64_t first = 0;         ///< Smallest failing dividend (if any)
+    };
+
+    namespace avx2 {
+        /// Checks DIVIDE_CASES.cases[index] for x in [begin, end); begin and end multiples of 8
+        DivideReport divide(size_t index, uint64_t begin, uint64_t end);
+    }
+
+    namespace avx512 {
+        /// Checks DIVIDE_CASES.cases[index] for x in [begin, end); begin and end multiples of 16
+        DivideReport divide(size_t index, uint64_t begin, uint64_t end);
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file check_divide_simd.cpp
+ * @brief Lane code of the division check, built once with AVX2 and once with AVX-512 flags
+ */
+#include <array>
+#include "check_divide.h"
+#include "simd_divide.h"
+
+#if defined(__AVX512F__)
+namespace impl::check::avx512 {
+#else
+namespace impl::check::avx2 {
+#endif
+    namespace {
+#if defined(__AVX512F__)
+        using Vec = __m512i;
+        constexpr unsigned LANES = 16;
+
+        inline Vec lanes(uint64_t x) {
+            return _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(x)),
+                                    _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        }
+
+        inline void store(uint32_t* out, Vec v) {
+            _mm512_storeu_si512(out, v);
+        }
+#else
+        using Vec = __m256i;
+        constexpr unsigned LANES = 8;
+
+        inline Vec lanes(uint64_t x) {
+            return _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(x)),
+                                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        }
+
+        inline void store(uint32_t* out, Vec v) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+        }
+#endif
+
+        template <uint32_t D, unsigned Bits>
+        DivideReport run(uint64_t begin, uint64_t end) {
+            DivideReport report;
+            uint32_t q[LANES];
+            uint32_t r[LANES];
+            for (uint64_t x = begin; x < end; x += LANES) {
+                const Vec v = lanes(x);
+                const Vec quotient = simd::div_epu32<D, Bits>(v);
+                store(q, quotient);
+                store(r, simd::rem_epu32<D>(v, quotient));
+                for (unsigned i = 0; i < LANES; ++i) {
+                    const uint32_t value = static_cast<uint32_t>(x + i);
+                    if (q[i] != value / D || r[i] != value % D) {
+                        if (report.mismatches++ == 0) report.first = value;
+                    }
+                }
+            }
+            return report;
+        }
+
+        template <size_t Index>
+        DivideReport runCase(uint64_t begin, uint64_t end) {
+            return run<DIVIDE_CASES.cases[Index].divisor, DIVIDE_CASES.cases[Index].bits>(begin, end);
+        }
+
+        using RunFn = DivideReport (*)(uint64_t, uint64_t);
+
+        template <size_t... Index>
+        constexpr auto makeTable(std::index_sequence<Index...>) {
+            return std::array<RunFn, sizeof...(Index)>{runCase<Index>...};
+        }
+    }
+
+    DivideReport divide(size_t index, uint64_t begin, uint64_t end) {
+        static constexpr auto RUN = makeTable(std::make_index_sequence<DIVIDE_CASE_COUNT>{});
+        return RUN[index](begin, end);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Serialization of streaming-search checkpoints
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include "checkpoint.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace impl::checkpoint {
+    namespace {
+        constexpr char MAGIC[8] = {'P', 'D', 'C', 'K', 'P', 'T', '0', '1'};
+        constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+        constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+        // magic, params, watermark, searched, maxVal, bestK, bestN, count
+        constexpr size_t HEADER = 8 + 5 * 8 + 4 + 4;
+
+        /// Flushes file through to the disk; false on any failure
+        bool syncFile(std::FILE* file) {
+            if (std::fflush(file) != 0) return false;
+#if defined(_WIN32)
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+
+        /// Makes a rename into the directory of path durable (no-op on Windows)
+        void syncDirectory(const char* path) {
+#if !defined(_WIN32)
+            std::string dir = std::filesystem::path(path).parent_path().string();
+            if (dir.empty()) dir = ".";
+            const int fd = open(dir.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            fsync(fd);
+            close(fd);
+#else
+            (void)path;
+#endif
+        }
+
+        uint64_t fnv1a(const unsigned char* bytes, size_t length, uint64_t h = FNV_OFFSET) {
+            for (size_t i = 0; i < length; ++i) {
+                h ^= bytes[i];
+                h *= FNV_PRIME;
+            }
+            return h;
+        }
+
+        void put(std::vector<unsigned char>& out, uint64_t v, int bytes) {
+            for (int b = 0; b < bytes; ++b) out.push_back(static_cast<unsigned char>(v >> (8 * b)));
+        }
+
+        uint64_t get(const unsigned char*& p, int bytes) {
+            uint64_t v = 0;
+            for (int b = 0; b < bytes; ++b) v |= uint64_t{p[b]} << (8 * b);
+            p += bytes;
+            return v;
+        }
+    }
+
+    bool State::done(uint64_t c) const {
+        return c < watermark || std::binary_search(finished.begin(), finished.end(), c);
+    }
+
+    void State::finish(uint64_t c) {
+        if (c == watermark) {
+            ++watermark;
+            // Chunks finished out of order that are now contiguous
+            auto it = finished.begin();
+            while (it != finished.end() && *it == watermark) {
+                ++watermark;
+                ++it;
+            }
+            finished.erase(finished.begin(), it);
+        } else if (c > watermark) {
+            finished.insert(std::lower_bound(finished.begin(), finished.end(), c), c);
+        }
+    }
+
+    uint64_t hash(int base, bool zero, uint64_t kBegin, uint64_t kEnd, uint64_t chunk) {
+        std::vector<unsigned char> key(MAGIC, MAGIC + sizeof(MAGIC));
+        const char* engine = "stream";
+        key.insert(key.end(), engine, engine + std::strlen(engine));
+        put(key, static_cast<uint64_t>(base), 4);
+        put(key, zero ? 1 : 0, 1);
+        put(key, kBegin, 8);
+        put(key, kEnd, 8);
+        put(key, chunk, 8);
+        return fnv1a(key.data(), key.size());
+    }
+
+    bool save(const char* path, const State& state) {
+        std::vector<unsigned char> bytes(MAGIC, MAGIC + sizeof(MAGIC));
+        bytes.reserve(HEADER + 8 * (state.finished.size() + 1));
+        put(bytes, state.params, 8);
+        put(bytes, state.watermark, 8);
+        put(bytes, state.searched, 8);
+        put(bytes, state.best.maxVal, 8);
+        put(bytes, state.best.bestK, 8);
+        put(bytes, static_cast<uint64_t>(state.best.bestN), 4);
+        put(bytes, state.finished.size(), 4);
+        for (uint64_t c : state.finished) put(bytes, c, 8);
+        put(bytes, fnv1a(bytes.data(), bytes.size()), 8);
+
+        const std::string temp = std::string(path) + ".tmp";
+        std::FILE* file = std::fopen(temp.c_str(), "wb");
+        if (!file) return false;
+        // The data has to be on disk before the rename makes it the
+        // checkpoint, or a crash can leave an empty or truncated file
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = ok && syncFile(file);
+        ok = std::fclose(file) == 0 && ok;
+
+        std::error_code ec;
+        if (ok) std::filesystem::rename(temp, path, ec);
+        if (!ok || ec) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        syncDirectory(path);
+        return true;
+    }
+
+    Load load(const char* path, uint64_t params, State& state) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) return Load::Missing;
+        std::vector<unsigned char> bytes;
+        unsigned char block[4096];
+        for (size_t got; (got = std::fread(block, 1, sizeof(block), file)) > 0;) {
+            bytes.insert(bytes.end(), block, block + got);
+        }
+        std::fclose(file);
+
+        if (bytes.size() < HEADER + 8 || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+            return Load::Corrupt;
+        }
+        const unsigned char* p = bytes.data() + sizeof(MAGIC);
+        State s;
+        s.params = get(p, 8);
+        s.watermark = get(p, 8);
+        s.searched = get(p, 8);
+        s.best.maxVal = get(p, 8);
+        s.best.bestK = get(p, 8);
+        s.best.bestN = static_cast<int>(get(p, 4));
+        const uint64_t count = get(p, 4);
+        if (bytes.size() != HEADER + 8 * (count + 1)) return Load::Corrupt;
+        for (uint64_t i = 0; i < count; ++i) s.finished.push_back(get(p, 8));
+        if (get(p, 8) != fnv1a(bytes.data(), bytes.size() - 8)) return Load::Corrupt;
+        if (s.params != params) return Load::Mismatch;
+
+        state = std::move(s);
+        return Load::Ok;
+    }
+}
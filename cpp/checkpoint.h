@@ -0,0 +1,64 @@
+/**
+ * @file checkpoint.h
+ * @brief Checkpoint files of the streaming search
+ *
+ * stream::search claims chunks in ascending order, so the finished work
+ * is a watermark (every chunk below it is done) plus the few chunks above
+ * it that workers finished out of order. Together with the best Result
+ * so far that is the whole search state, a few dozen bytes regardless of
+ * the range size.
+ *
+ * File layout (little-endian): 8-byte magic "PDCKPT01", u64 parameter
+ * hash, u64 watermark, u64 k values searched, u64 maxVal, u64 bestK,
+ * u32 bestN, u32 count, count x u64 finished chunk indices, then a u64
+ * FNV-1a checksum of everything before it. save() writes a temporary
+ * file and renames it over the old one, so a killed process leaves either
+ * the previous or the new checkpoint, never a torn one.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "stream.h"
+
+namespace impl::checkpoint {
+    /**
+     * @struct State
+     * @brief Progress of one streaming search
+     */
+    struct State {
+        uint64_t params = 0;              ///< hash() of the search it belongs to
+        uint64_t watermark = 0;           ///< Chunks [0, watermark) are finished
+        std::vector<uint64_t> finished;   ///< Finished chunks above the watermark, ascending
+        uint64_t searched = 0;            ///< k values in finished chunks
+        stream::Result best;              ///< Best hit of the finished chunks
+
+        /// Whether chunk c is finished
+        bool done(uint64_t c) const;
+
+        /// Marks chunk c finished and advances the watermark
+        void finish(uint64_t c);
+    };
+
+    /**
+     * @brief Identifies a search: engine, base, mode, clamped k range and chunk
+     *
+     * The AVX2 and scalar kernels give identical results, so the kernel
+     * choice is not part of the hash and a checkpoint can resume on any host.
+     */
+    uint64_t hash(int base, bool zero, uint64_t kBegin, uint64_t kEnd, uint64_t chunk);
+
+    /// Atomically replaces path with state; false on I/O errors
+    bool save(const char* path, const State& state);
+
+    enum class Load {
+        Ok,         ///< state holds the checkpoint
+        Missing,    ///< No file at path
+        Corrupt,    ///< Bad magic, size or checksum
+        Mismatch,   ///< Written by a different search
+    };
+
+    /// Reads path into state if it belongs to the search params
+    Load load(const char* path, uint64_t params, State& state);
+}
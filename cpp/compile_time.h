@@ -0,0 +1,77 @@
+/**
+ * @file compile_time.h
+ * @brief constexpr search evaluated entirely by the compiler
+ *
+ * The answer for a fixed configuration never changes, so this engine runs
+ * the search in a constant expression: digit masks, concatenation and the
+ * mergeMax reduction are all constexpr. ANSWER<...> is a compile-time
+ * constant that costs nothing at runtime and serves as a static_assert
+ * oracle for the runtime engines (see main.cpp).
+ *
+ * Template parameters: the largest k, the range of n and the base (digits
+ * 1..Base-1). The compiler's constexpr step limit bounds MaxK in practice;
+ * the default base-10 search and the small bases fit comfortably, while
+ * base 16 (k up to 16^7) is for the runtime radix engines.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "calc_result.h"
+
+namespace impl::compile_time {
+    /// Concatenation, digit count and digit mask of k*1 || ... || k*n
+    struct Concat {
+        uint64_t value = 0;
+        int digits = 0;
+        uint32_t mask = 0;
+        bool bad = false;   ///< A 0 or a repeated digit was seen
+    };
+
+    /// Appends p in base Base to c
+    template <int Base>
+    constexpr void append(Concat& c, uint32_t p) {
+        uint64_t scale = 1;
+        for (uint32_t v = p; v != 0; v /= Base) {
+            const uint32_t bit = 1u << (v % Base);
+            c.bad = c.bad || (bit & 1u) || (c.mask & bit);
+            c.mask |= bit;
+            scale *= Base;
+            ++c.digits;
+        }
+        c.value = c.value * scale + p;
+    }
+
+    /**
+     * @brief Largest pandigital concatenated product for k = 1..MaxK and n = MinN..MaxN
+     *
+     * Same walk and tie-breaking as the runtime engines, so the result is
+     * directly comparable with theirs.
+     */
+    template <int MaxK = 9999, int MinN = 2, int MaxN = 9, int Base = 10>
+    constexpr CalcResult calc() {
+        static_assert(Base >= 2 && Base <= 16, "base must be 2..16");
+        static_assert(MinN >= 2 && MinN <= MaxN, "n range must start at 2 or above");
+        constexpr int DIGITS = Base - 1;
+        constexpr uint32_t FULL_MASK = ((1u << Base) - 1) & ~1u;
+
+        CalcResult result = {0, 0, 0};
+        for (int k = 1; k <= MaxK; ++k) {
+            Concat c;
+            for (int n = 1; n <= MaxN; ++n) {
+                Concat next = c;
+                append<Base>(next, static_cast<uint32_t>(k) * static_cast<uint32_t>(n));
+                if (next.digits > DIGITS || next.bad) break;
+                c = next;
+                if (n >= MinN && c.digits == DIGITS && c.mask == FULL_MASK) {
+                    mergeMax(result, {c.value, k, n});
+                }
+            }
+        }
+        return result;
+    }
+
+    /// Folded result of calc<MaxK, MinN, MaxN, Base>()
+    template <int MaxK = 9999, int MinN = 2, int MaxN = 9, int Base = 10>
+    inline constexpr CalcResult ANSWER = calc<MaxK, MinN, MaxN, Base>();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file cpu_features.cpp
+ * @brief cpuid/xgetbv based feature probing
+ *
+ * Bits used:
+ * - Leaf 1 ECX: FMA (12), OSXSAVE (27), AVX (28)
+ * - Leaf 7 EBX: AVX2 (5), AVX512F (16), AVX512DQ (17), AVX512BW (30), AVX512VL (31)
+ * - Leaf 7 ECX: AVX512VBMI (1), AVX512VPOPCNTDQ (14)
+ * - XCR0: SSE/AVX state (bits 1-2), opmask/ZMM state (bits 5-7)
+ *
+ * This file is compiled without any -m flags so it runs on every x86-64 host.
+ */
+#include "cpu_features.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace impl::cpu {
+    namespace {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        bool cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+            int info[4];
+            // Highest supported leaf of the basic or extended range
+            __cpuid(info, static_cast<int>(leaf & 0x80000000u));
+            if (static_cast<unsigned>(info[0]) < leaf) return false;
+            __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+            for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(info[i]);
+            return true;
+#else
+            return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]) != 0;
+#endif
+        }
+
+        unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            unsigned eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        }
+#endif
+    }
+
+    CpuFeatures detect() {
+        CpuFeatures f;
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        unsigned regs[4];
+        if (!cpuid(1, 0, regs)) return f;
+
+        bool osxsave = (regs[2] & (1u << 27)) != 0;
+        bool avx = (regs[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx) return f;
+
+        unsigned long long xcr0 = xgetbv0();
+        bool osAVX = (xcr0 & 0x6) == 0x6;
+        bool osAVX512 = osAVX && (xcr0 & 0xE0) == 0xE0;
+        if (!osAVX) return f;
+
+        f.fma = (regs[2] & (1u << 12)) != 0;
+
+        if (!cpuid(7, 0, regs)) return f;
+        f.avx2 = (regs[1] & (1u << 5)) != 0;
+        if (osAVX512) {
+            f.avx512f = (regs[1] & (1u << 16)) != 0;
+            f.avx512dq = f.avx512f && (regs[1] & (1u << 17)) != 0;
+            f.avx512bw = f.avx512f && (regs[1] & (1u << 30)) != 0;
+            f.avx512vl = f.avx512f && (regs[1] & (1u << 31)) != 0;
+            f.avx512vbmi = f.avx512f && (regs[2] & (1u << 1)) != 0;
+            f.avx512vpopcntdq = f.avx512f && (regs[2] & (1u << 14)) != 0;
+        }
+#endif
+        return f;
+    }
+
+    const CpuFeatures& features() {
+        static const CpuFeatures cached = detect();
+        return cached;
+    }
+
+    std::string vendor() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        unsigned regs[4];
+        if (cpuid(0, 0, regs)) {
+            char text[13] = {};
+            const unsigned order[3] = {regs[1], regs[3], regs[2]};   // EBX, EDX, ECX
+            for (int r = 0; r < 3; ++r) {
+                for (int b = 0; b < 4; ++b) {
+                    text[r * 4 + b] = static_cast<char>((order[r] >> (8 * b)) & 0xFF);
+                }
+            }
+            return text;
+        }
+#endif
+        return "unknown";
+    }
+
+    std::string brand() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        unsigned regs[4];
+        if (cpuid(0x80000000u, 0, regs) && regs[0] >= 0x80000004u) {
+            char text[49] = {};
+            for (unsigned leaf = 0; leaf < 3; ++leaf) {
+                cpuid(0x80000002u + leaf, 0, regs);
+                for (int r = 0; r < 4; ++r) {
+                    for (int b = 0; b < 4; ++b) {
+                        text[leaf * 16 + r * 4 + b] = static_cast<char>((regs[r] >> (8 * b)) & 0xFF);
+                    }
+                }
+            }
+            std::string s(text);
+            size_t first = s.find_first_not_of(' ');
+            size_t last = s.find_last_not_of(' ');
+            if (first != std::string::npos) return s.substr(first, last - first + 1);
+        }
+#endif
+        return "unknown";
+    }
+
+    std::string describe(const CpuFeatures& f) {
+        std::string s;
+        auto add = [&s](bool on, const char* name) {
+            if (!on) return;
+            if (!s.empty()) s += ' ';
+            s += name;
+        };
+        add(f.avx2, "avx2");
+        add(f.fma, "fma");
+        add(f.avx512f, "avx512f");
+        add(f.avx512bw, "avx512bw");
+        add(f.avx512dq, "avx512dq");
+        add(f.avx512vl, "avx512vl");
+        add(f.avx512vbmi, "avx512vbmi");
+        add(f.avx512vpopcntdq, "avx512vpopcntdq");
+        return s.empty() ? "none" : s;
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * @file cpu_features.h
+ * @brief Runtime detection of the SIMD extensions used by the engines
+ */
+
+#pragma once
+
+#include <string>
+
+namespace impl::cpu {
+    /**
+     * @struct CpuFeatures
+     * @brief SIMD extensions supported by both the CPU and the OS
+     *
+     * A flag is only set when the OS also saves the matching register
+     * state (checked through XGETBV), so a set flag is safe to execute.
+     */
+    struct CpuFeatures {
+        bool avx2 = false;
+        bool fma = false;
+        bool avx512f = false;
+        bool avx512bw = false;
+        bool avx512dq = false;
+        bool avx512vl = false;
+        bool avx512vbmi = false;
+        bool avx512vpopcntdq = false;
+    };
+
+    /// Probes the running CPU via cpuid (MSVC, GCC and Clang)
+    CpuFeatures detect();
+
+    /// Cached result of detect() for the current process
+    const CpuFeatures& features();
+
+    /// Vendor id from cpuid leaf 0, e.g. "GenuineIntel" or "AuthenticAMD"
+    std::string vendor();
+
+    /// Processor brand string from cpuid leaves 0x80000002-4 ("unknown" if unavailable)
+    std::string brand();
+
+    /// Space-separated list of the detected extensions, e.g. "avx2 fma avx512f"
+    std::string describe(const CpuFeatures& f);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file digit_table.h
+ * @brief Precomputed digit-mask table for 0..9999
+ *
+ * Each 16-bit entry packs:
+ * - bits 0-9:   digit mask (bit d set if digit d occurs)
+ * - bits 10-12: number of decimal digits (1..4)
+ * - bit 13:     BAD flag, set if the number contains a 0 or a repeated digit
+ *
+ * Products up to 99999 are split as hi = p / 10000, lo = p % 10000; when
+ * hi > 0, lo is written with leading zeros, so lo < 1000 means a 0 digit.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace impl::digit_table {
+    constexpr int ENTRIES = 10000;
+    constexpr uint16_t MASK_BITS = 0x3FF;
+    constexpr int COUNT_SHIFT = 10;
+    constexpr uint16_t COUNT_BITS = 0x7;
+    constexpr uint16_t BAD_FLAG = 1u << 13;
+
+    /**
+     * @struct TableStats
+     * @brief Footprint and build cost of the table
+     */
+    struct TableStats {
+        size_t entries;   ///< Valid entries (0..9999)
+        size_t bytes;     ///< Allocated size including gather padding
+        double buildUs;   ///< Time to build the table in microseconds
+    };
+
+    /**
+     * @brief Returns the table, building it on first use
+     *
+     * One padding entry follows the last valid one so that 32-bit gathers
+     * at scale 2 (which read entry i and i+1) never leave the array.
+     */
+    const uint16_t* table();
+
+    /// Footprint and build time; builds the table if needed
+    TableStats stats();
+}
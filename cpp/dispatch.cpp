@@ -0,0 +1,129 @@
+/**
+ * @file dispatch.cpp
+ * @brief Dispatch table and startup selection
+ *
+ * Compiled without ISA flags: it only calls through function pointers
+ * and never executes an instruction the host might lack.
+ */
+#include <atomic>
+#include <cstring>
+#include "dispatch.h"
+#include "engines.h"
+
+namespace impl::dispatch {
+    namespace {
+        bool always(const cpu::CpuFeatures&) { return true; }
+
+        bool hasAVX2(const cpu::CpuFeatures& f) { return f.avx2; }
+
+        bool hasAVX2FMA(const cpu::CpuFeatures& f) { return f.avx2 && f.fma; }
+
+        bool hasAVX512(const cpu::CpuFeatures& f) {
+            return f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl;
+        }
+
+        using Calc = CalcResult (*)();
+        using Range = CalcResult (*)(int, int);
+        using Unrolled = CalcResult (*)(int, int, int);
+
+        constexpr int MAX_K = 9999;
+
+        const Engine ENGINES[] = {
+            {"lut_avx512", "LUT AVX-512", hasAVX512,
+             static_cast<Calc>(lut_avx512::calc), static_cast<Range>(lut_avx512::calc),
+             nullptr, lut_avx512::topK,
+             static_cast<Unrolled>(lut_avx512::calc)},
+            {"avx512", "AVX-512", hasAVX512,
+             static_cast<Calc>(avx512::calc), static_cast<Range>(avx512::calc),
+             avx512::enumerate, avx512::topK,
+             static_cast<Unrolled>(avx512::calc)},
+            {"lut_avx2", "LUT AVX2", hasAVX2,
+             static_cast<Calc>(lut_avx2::calc), static_cast<Range>(lut_avx2::calc),
+             nullptr, lut_avx2::topK,
+             static_cast<Unrolled>(lut_avx2::calc)},
+            {"avx2_advanced", "AVX2 Advanced", hasAVX2FMA,
+             static_cast<Calc>(avx2_advanced::calc), static_cast<Range>(avx2_advanced::calc),
+             avx2_advanced::enumerate, avx2_advanced::topK,
+             static_cast<Unrolled>(avx2_advanced::calc)},
+            {"avx2", "AVX2", hasAVX2,
+             static_cast<Calc>(avx2::calc), static_cast<Range>(avx2::calc),
+             avx2::enumerate, avx2::topK, nullptr},
+            {"base_simd", "Base SIMD", hasAVX2,
+             static_cast<Calc>(base_simd::calc), static_cast<Range>(base_simd::calc),
+             base_simd::enumerate, base_simd::topK, nullptr},
+            {"portable", "Portable", always,
+             static_cast<Calc>(portable::calc), static_cast<Range>(portable::calc),
+             portable::enumerate, portable::topK, nullptr},
+            {"simple", "Simple", always,
+             static_cast<Calc>(simple::calc), static_cast<Range>(simple::calc),
+             simple::enumerate, simple::topK, nullptr},
+        };
+
+        constexpr size_t ENGINE_COUNT = sizeof(ENGINES) / sizeof(ENGINES[0]);
+
+        // Set by select(); nullptr keeps the startup choice
+        std::atomic<const Engine*> tuned{nullptr};
+        std::atomic<int> depth{DEFAULT_UNROLL};
+    }
+
+    const Engine* engines(size_t& count) {
+        count = ENGINE_COUNT;
+        return ENGINES;
+    }
+
+    const Engine* find(const char* id) {
+        for (const auto& e : ENGINES) {
+            if (std::strcmp(e.id, id) == 0) return &e;
+        }
+        return nullptr;
+    }
+
+    const Engine& best(const cpu::CpuFeatures& features) {
+        for (const auto& e : ENGINES) {
+            if (e.supported(features)) return e;
+        }
+        return ENGINES[ENGINE_COUNT - 1];
+    }
+
+    const Engine& selected() {
+        // Resolved on first use; main() forces this at startup
+        static const Engine& engine = best(cpu::features());
+        const Engine* chosen = tuned.load(std::memory_order_acquire);
+        return chosen ? *chosen : engine;
+    }
+
+    void select(const Engine& engine, int unroll) {
+        depth.store(unroll, std::memory_order_relaxed);
+        tuned.store(&engine, std::memory_order_release);
+    }
+
+    int unroll() {
+        return depth.load(std::memory_order_relaxed);
+    }
+
+    const Engine& enumerator() {
+        if (selected().enumerate) return selected();
+        for (const auto& e : ENGINES) {
+            if (e.enumerate && e.supported(cpu::features())) return e;
+        }
+        return ENGINES[ENGINE_COUNT - 1];
+    }
+
+    const Engine& ranker() {
+        if (selected().topK) return selected();
+        for (const auto& e : ENGINES) {
+            if (e.topK && e.supported(cpu::features())) return e;
+        }
+        return ENGINES[ENGINE_COUNT - 1];
+    }
+
+    CalcResult calc() {
+        const Engine& e = selected();
+        return e.calcUnrolled ? e.calcUnrolled(1, MAX_K, unroll()) : e.calc();
+    }
+
+    CalcResult calc(int kBegin, int kEnd) {
+        const Engine& e = selected();
+        return e.calcUnrolled ? e.calcUnrolled(kBegin, kEnd, unroll()) : e.calcRange(kBegin, kEnd);
+    }
+}
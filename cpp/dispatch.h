@@ -0,0 +1,73 @@
+/**
+ * @file dispatch.h
+ * @brief Function-pointer dispatch table over all engines
+ *
+ * Entries are ordered fastest first. At startup the first entry whose
+ * requirements are met by the running CPU becomes the dispatched kernel,
+ * so a single binary uses the best engine on every host. A tuning
+ * profile (tuning.h) can replace that choice with the engine and unroll
+ * depth that measured fastest on the host.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+#include "cpu_features.h"
+
+namespace impl::dispatch {
+    /**
+     * @struct Engine
+     * @brief One row of the dispatch table
+     */
+    struct Engine {
+        const char* id;                                ///< Short identifier, e.g. "avx2"
+        const char* name;                              ///< Display name
+        bool (*supported)(const cpu::CpuFeatures&);    ///< CPU requirements
+        CalcResult (*calc)();                          ///< Full search
+        CalcResult (*calcRange)(int kBegin, int kEnd); ///< Range kernel
+        void (*enumerate)(int kBegin, int kEnd, hits::HitBuffer& out); ///< nullptr if unsupported
+        void (*topK)(int kBegin, int kEnd, hits::TopK& heap);          ///< nullptr if unsupported
+        CalcResult (*calcUnrolled)(int kBegin, int kEnd, int unroll);  ///< nullptr if the depth is fixed
+    };
+
+    /// Batches per loop step of the unrollable kernels unless tuned
+    constexpr int DEFAULT_UNROLL = 2;
+
+    /// All engines, fastest first
+    const Engine* engines(size_t& count);
+
+    /// Looks up an engine by id; nullptr if unknown
+    const Engine* find(const char* id);
+
+    /// First supported engine for the given features
+    const Engine& best(const cpu::CpuFeatures& features);
+
+    /// Engine selected for this process at startup
+    const Engine& selected();
+
+    /**
+     * @brief Replaces the startup selection, e.g. with a tuned profile
+     *
+     * Call before starting searches; calc() picks the change up on its
+     * next call. unroll is ignored by engines without calcUnrolled.
+     */
+    void select(const Engine& engine, int unroll = DEFAULT_UNROLL);
+
+    /// Unroll depth used with the selected engine
+    int unroll();
+
+    /// The selected engine if it can enumerate hits, else the fastest supported one that can
+    const Engine& enumerator();
+
+    /// The selected engine if it has a top-K kernel, else the fastest supported one that has
+    const Engine& ranker();
+
+    /// Full search through the selected engine
+    CalcResult calc();
+
+    /// Range search through the selected engine at the selected unroll depth
+    CalcResult calc(int kBegin, int kEnd);
+}
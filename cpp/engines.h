@@ -0,0 +1,95 @@
+/**
+ * @file engines.h
+ * @brief Entry points of every pandigital engine
+ *
+ * Each engine exposes a full search over its default k range and a range
+ * variant over [kBegin, kEnd] (inclusive) that the parallel driver uses
+ * to split the work. Engines that can list every hit, not just the
+ * maximum, also provide enumerate() over the same range. Every engine
+ * but descending provides topK(), which keeps the K best hits of a range
+ * in a bounded heap, and calcTopK() over the default range.
+ *
+ * The register-resident SIMD kernels (avx512, avx2_advanced, lut_avx2,
+ * lut_avx512) also take an unroll depth: the number of independent
+ * batches evaluated per loop step (1, 2 or 4; 2 by default). The
+ * autotuner (tuning.h) picks the depth per host.
+ *
+ * portable is the table-driven scalar engine for hosts without AVX2:
+ * no ISA flags, no allocation and no libc calls in the search.
+ *
+ * descending is the exception to the k scan: it walks pandigitals from
+ * the largest down and stops at the first one with product structure.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+
+namespace impl {
+    namespace simple {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace portable {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace base_simd {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace avx2 {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace avx512 {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        CalcResult calc(int kBegin, int kEnd, int unroll);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace avx2_advanced {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        CalcResult calc(int kBegin, int kEnd, int unroll);
+        void enumerate(int kBegin, int kEnd, hits::HitBuffer& out);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace lut_avx2 {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        CalcResult calc(int kBegin, int kEnd, int unroll);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace lut_avx512 {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+        CalcResult calc(int kBegin, int kEnd, int unroll);
+        void topK(int kBegin, int kEnd, hits::TopK& heap);
+        std::vector<hits::Hit> calcTopK(size_t count);
+    }
+    namespace descending {
+        CalcResult calc();
+        CalcResult calc(int kBegin, int kEnd);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file hits.cpp
+ * @brief HitBuffer flushing and the binary hit writer
+ */
+#include <utility>
+#include "hits.h"
+
+namespace impl::hits {
+    HitBuffer::HitBuffer(Sink s) : sink(std::move(s)) {}
+
+    HitBuffer::~HitBuffer() {
+        flush();
+    }
+
+    void HitBuffer::flush() {
+        if (used == 0) return;
+        for (size_t i = 0; i < used; ++i) {
+            staging[i] = {valueCol[i], kCol[i], nCol[i]};
+        }
+        if (sink) sink(staging, used);
+        used = 0;
+    }
+
+    BinaryWriter::BinaryWriter(const char* path) : file(std::fopen(path, "wb")) {
+        if (file && std::fwrite("PDHITS01", 1, 8, file) != 8) failed = true;
+    }
+
+    BinaryWriter::~BinaryWriter() {
+        if (file) std::fclose(file);
+    }
+
+    void BinaryWriter::write(const Hit* hits, size_t count) {
+        if (!ok()) return;
+        unsigned char record[12];
+        auto put = [&record](int offset, int v) {
+            uint32_t u = static_cast<uint32_t>(v);
+            for (int b = 0; b < 4; ++b) record[offset + b] = static_cast<unsigned char>(u >> (8 * b));
+        };
+        for (size_t i = 0; i < count; ++i) {
+            put(0, hits[i].value);
+            put(4, hits[i].k);
+            put(8, hits[i].n);
+            if (std::fwrite(record, 1, sizeof(record), file) != sizeof(record)) {
+                failed = true;
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/**
+ * @file hits.h
+ * @brief Streaming of every pandigital concatenated product (k, n, value)
+ *
+ * Kernels append hits to a HitBuffer: a fixed-capacity structure-of-arrays
+ * staging area that SIMD code can compress-store lanes into directly
+ * (_mm512_mask_compressstoreu_epi32 or an AVX2 permute + store). Full
+ * buffers are handed to a caller-supplied Sink, so no allocation happens
+ * per hit.
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+
+namespace impl::hits {
+    /**
+     * @struct Hit
+     * @brief One pandigital concatenated product k*1 || ... || k*n
+     */
+    struct Hit {
+        int value;
+        int k;
+        int n;
+    };
+
+    /// Orders hits by value descending, then k, then n ascending
+    inline bool greater(const Hit& a, const Hit& b) {
+        if (a.value != b.value) return a.value > b.value;
+        if (a.k != b.k) return a.k < b.k;
+        return a.n < b.n;
+    }
+
+    /// Number of lanes set in a compare mask
+    inline size_t laneCount(unsigned mask) {
+        return std::bitset<32>(mask).count();
+    }
+
+    /// Receives hits in blocks of up to HitBuffer::CAPACITY
+    using Sink = std::function<void(const Hit* hits, size_t count)>;
+
+    /**
+     * @class HitBuffer
+     * @brief Fixed-capacity SoA hit staging buffer
+     *
+     * SIMD kernels call reserve(lanes), store up to `lanes` entries at
+     * values() / ks() / ns() and then commit() the number actually kept.
+     * SLACK extra slots allow full-width vector stores past the last hit.
+     */
+    class HitBuffer {
+    public:
+        static constexpr size_t CAPACITY = 1024;
+        static constexpr size_t SLACK = 16;
+
+        explicit HitBuffer(Sink sink);
+        ~HitBuffer();
+
+        HitBuffer(const HitBuffer&) = delete;
+        HitBuffer& operator=(const HitBuffer&) = delete;
+
+        /// Flushes if fewer than `lanes` slots are free
+        void reserve(size_t lanes) {
+            if (used + lanes > CAPACITY) flush();
+        }
+
+        int* values() { return valueCol + used; }
+        int* ks() { return kCol + used; }
+        int* ns() { return nCol + used; }
+
+        /// Accepts `count` entries written at the tail pointers
+        void commit(size_t count) {
+            used += count;
+            total += count;
+        }
+
+        /// Scalar append
+        void push(int value, int k, int n) {
+            reserve(1);
+            valueCol[used] = value;
+            kCol[used] = k;
+            nCol[used] = n;
+            commit(1);
+        }
+
+        /// Hands the buffered hits to the sink
+        void flush();
+
+        /// Hits appended since construction
+        uint64_t appended() const { return total; }
+
+    private:
+        alignas(64) int valueCol[CAPACITY + SLACK];
+        alignas(64) int kCol[CAPACITY + SLACK];
+        alignas(64) int nCol[CAPACITY + SLACK];
+        Hit staging[CAPACITY];
+        size_t used = 0;
+        uint64_t total = 0;
+        Sink sink;
+    };
+
+    /**
+     * @class BinaryWriter
+     * @brief Writes hits as 12-byte little-endian records
+     *
+     * File layout: 8-byte magic "PDHITS01", then per hit
+     * u32 value, u32 k, u32 n.
+     */
+    class BinaryWriter {
+    public:
+        /// Opens path for writing; check ok() afterwards
+        explicit BinaryWriter(const char* path);
+        ~BinaryWriter();
+
+        BinaryWriter(const BinaryWriter&) = delete;
+        BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+        bool ok() const { return file != nullptr && !failed; }
+        void write(const Hit* hits, size_t count);
+
+    private:
+        std::FILE* file;
+        bool failed = false;
+    };
+}
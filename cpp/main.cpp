@@ -3,153 +3,806 @@
  * @brief Main program entry point and benchmarking framework for pandigital number calculator
  * 
  * This file contains:
- * 1. CPU feature detection for SIMD instructions
- * 2. Benchmarking framework for comparing implementations
- * 3. Result presentation and formatting
+ * 1. Runtime kernel selection via the cpuid dispatch table
+ * 2. Command line handling for the benchmark harness (benchmark.h)
+ * 3. Result presentation as a table, JSON or CSV
  * 
  * The program compares different implementations:
  * - Simple (sequential)
+ * - Portable (table-driven scalar, no ISA extensions)
  * - Base SIMD (AVX2)
- * - Advanced AVX2
- * - AVX-512 (when supported)
+ * - AVX2
+ * - Advanced AVX2 (when AVX2 + FMA are supported)
+ * - AVX-512 (when AVX-512F/BW/DQ/VL are supported)
+ * - Table-driven AVX2 / AVX-512 (digit-mask lookup table + gathers)
+ * - Descending inverse search (stops at the largest pandigital hit)
+ *
+ * Results are checked against EXPECTED, which the compiler computes
+ * from the constexpr search in compile_time.h; a wrong or inconsistent
+ * result makes the exit code 2.
+ *
+ * Every implementation is also run through the multi-threaded k-range
+ * driver (rows suffixed with "MT"), and the dispatched kernel through the
+ * k-interval planner ("Planned").
+ *
+ * With --enumerate the benchmark is skipped and every pandigital
+ * concatenated product is streamed to a binary hit file instead; --top K
+ * prints the K largest and --base B searches base B (2..16). --validate
+ * FILE checks a memory-mapped file of candidates (bulk.h). --stream runs
+ * the base-B search on the 64-bit streaming engine (stream.h) with
+ * progress reports; Ctrl+C stops it and prints the best hit so far.
+ * --processes P spreads a search over P worker processes (shard.h).
+ * --serve PATH answers queries on a Unix domain socket until Ctrl+C
+ * (service.h).
+ *
+ * At startup the host's tuning profile (tuning.h) selects the engine,
+ * unroll depth and chunk size; the first benchmark run on a host without
+ * one, or --autotune, measures the candidates and saves the winner.
  */
 
+#include <chrono>
 #include <iostream>
 #include <iomanip>
-#include <chrono>
 #include <vector>
 #include <functional>
-#include <numeric>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <algorithm>
-#include "calc_result.h"
-
-#ifdef _MSC_VER
-#include <intrin.h>
-#endif
-
-namespace impl {
-    namespace simple { CalcResult calc(); }  // Add this line
-    namespace base_simd { CalcResult calc(); }
-    namespace avx2 { CalcResult calc(); }
-    namespace avx512 { CalcResult calc(); }
-    namespace avx2_advanced { CalcResult calc(); }
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include "benchmark.h"
+#include "bulk.h"
+#include "cache.h"
+#include "compile_time.h"
+#include "cpu_features.h"
+#include "digit_table.h"
+#include "dispatch.h"
+#include "engines.h"
+#include "hits.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "planner.h"
+#include "radix.h"
+#include "service.h"
+#include "shard.h"
+#include "stream.h"
+#include "tuning.h"
+
+using RangeFn = impl::CalcResult (*)(int, int);
+
+// Folded by the compiler (compile_time.h); every runtime engine must agree
+constexpr impl::CalcResult EXPECTED = impl::compile_time::ANSWER<>;
+static_assert(EXPECTED.maxVal == 932718654 && EXPECTED.bestK == 9327 && EXPECTED.bestN == 2,
+              "compile-time search disagrees with the known base-10 answer");
+static_assert(impl::compile_time::ANSWER<511, 2, 7, 8>.maxVal == 1893724 &&   // 7162534 in base 8
+              impl::compile_time::ANSWER<511, 2, 7, 8>.bestK == 7,
+              "compile-time search disagrees with the known base-8 answer");
+
+/**
+ * @struct Options
+ * @brief Command line settings
+ */
+struct Options {
+    bench::Config bench;
+    const char* enumeratePath = nullptr;   ///< Hit file, "-" for text on stdout
+    bool sorted = false;                   ///< Sort hits before writing them
+    int top = 0;                           ///< Print the top K hits, 0 to benchmark
+    int base = 0;                          ///< Search this base (2..16), 0 to benchmark
+    bool zero = false;                     ///< Digits 0..B-1 (ten-digit 0-9 in base 10)
+    const char* validatePath = nullptr;    ///< Candidate file to validate
+    const char* outputPath = nullptr;      ///< Matches of --validate, "-" for stdout
+    impl::bulk::Options bulk;              ///< Input format and output kind of --validate
+    bool stream = false;                   ///< Search on the 64-bit streaming engine
+    uint64_t kMin = 1;                     ///< First k of --stream
+    uint64_t kMax = UINT64_MAX;            ///< Last k of --stream (clamped to the base's limit)
+    double progress = 1.0;                 ///< Seconds between --stream progress lines
+    const char* checkpointPath = nullptr;  ///< --stream checkpoint file
+    double checkpointEvery = 60.0;         ///< Seconds between checkpoint writes
+    const char* cachePath = nullptr;       ///< --stream result cache file
+    unsigned processes = 0;                ///< Worker processes of a sharded run, 0 for none
+    uint64_t shards = 0;                   ///< Shards of a sharded run, 0 for the default
+    std::string engine = "stream";         ///< Engine of a sharded run
+    std::string socketPath;                ///< Coordinator socket, empty for a private one
+    const char* joinPath = nullptr;        ///< Serve shards from this coordinator socket
+    const char* servePath = nullptr;       ///< Run the query service on this socket
+    bool autotune = false;                 ///< Re-measure and save this host's tuning profile
+    const char* profilePath = nullptr;     ///< Tuning profile, nullptr for tuning::defaultPath()
+    bool noProfile = false;                ///< Neither load nor create a tuning profile
+    bool help = false;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "  --warmup N          untimed calls per implementation (default 3)\n"
+              << "  --iterations N      timed samples per implementation (default 50)\n"
+              << "  --min-sample-us US  minimum duration of one sample (default 200)\n"
+              << "  --pin CPU           pin the benchmark thread to CPU\n"
+              << "  --format FMT        table, json or csv (default table)\n"
+              << "  --perf              read hardware counters (Linux perf_event_open)\n"
+              << "  --enumerate FILE    write every hit to FILE (binary, \"-\" for text on stdout)\n"
+              << "  --sorted            with --enumerate: order hits by value, descending\n"
+              << "  --top K             print the K largest hits with their k and n\n"
+              << "  --base B            find the largest base-B pandigital product (B = 2..16)\n"
+              << "  --zero              digits 0..B-1 instead of 1..B-1 (B <= 15, default base 10)\n"
+              << "  --validate FILE     check every candidate in FILE (memory-mapped)\n"
+              << "  --input FMT         with --validate: text, u32 or u64 (default text)\n"
+              << "  --output FILE       with --validate: write the matches to FILE (\"-\" for stdout)\n"
+              << "  --offsets           with --validate: write u64 byte offsets instead of values\n"
+              << "  --stream            search with 64-bit k (any base 2..16, --zero included)\n"
+              << "  --kmin K            with --stream: first k (default 1)\n"
+              << "  --kmax K            with --stream: last k (default: the base's limit)\n"
+              << "  --progress SEC      with --stream: seconds between progress lines (default 1)\n"
+              << "  --checkpoint FILE   with --stream: resume from FILE if present, save progress to it\n"
+              << "  --checkpoint-every SEC  seconds between checkpoint writes (default 60)\n"
+              << "  --cache FILE        with --stream: reuse and extend the interval results in FILE\n"
+              << "  --processes P       shard the search over P worker processes (Unix)\n"
+              << "  --shards N          with --processes: number of k-range shards (default 8 * P)\n"
+              << "  --engine ID         with --processes: stream (default) or a dispatch id, e.g. avx2\n"
+              << "  --socket PATH       with --processes: coordinator socket (default: temp directory)\n"
+              << "  --join PATH         serve shards for the coordinator listening at PATH\n"
+              << "  --serve PATH        answer best / top / enumerate queries on a Unix socket at PATH\n"
+              << "  --autotune          measure engine, unroll depth and chunk size, save the winner\n"
+              << "  --profile FILE      tuning profile (default $PANDIGITAL_PROFILE or ~/.pandigital-tuning)\n"
+              << "  --no-profile        ignore the tuning profile and use the built-in defaults\n"
+              << "  --help              show this message\n";
 }
 
 /**
- * @brief Checks CPU support for advanced SIMD features
- * @param checkAVX512 Whether to check for AVX-512 support
- * @return true if required features are supported
+ * @brief Parses argv into opts
+ * @return false on unknown options or malformed values
  */
-bool check_cpu_features(bool checkAVX512 = true) {
-#ifdef _MSC_VER
-    int cpuInfo[4];
-    __cpuid(cpuInfo, 0);
-    if (cpuInfo[0] >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        bool hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
-        if (checkAVX512) {
-            bool hasAVX512F = (cpuInfo[1] & (1 << 16)) != 0;
-            return hasAVX512F;
-        }
-        return hasAVX2;
-    }
-    return false;
-#else
-    return false;
-#endif
+bool parseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char*& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        const char* v = nullptr;
+        if (arg == "--help") {
+            opts.help = true;
+        } else if (arg == "--perf") {
+            opts.bench.perf = true;
+        } else if (arg == "--warmup" && value(v)) {
+            opts.bench.warmup = std::atoi(v);
+        } else if (arg == "--iterations" && value(v)) {
+            opts.bench.iterations = std::max(1, std::atoi(v));
+        } else if (arg == "--min-sample-us" && value(v)) {
+            opts.bench.minSampleUs = std::atof(v);
+        } else if (arg == "--pin" && value(v)) {
+            opts.bench.pinCpu = std::atoi(v);
+        } else if (arg == "--enumerate" && value(v)) {
+            opts.enumeratePath = v;
+        } else if (arg == "--sorted") {
+            opts.sorted = true;
+        } else if (arg == "--top" && value(v)) {
+            opts.top = std::atoi(v);
+            if (opts.top <= 0) return false;
+        } else if (arg == "--base" && value(v)) {
+            opts.base = std::atoi(v);
+            if (opts.base < impl::radix::MIN_BASE || opts.base > impl::radix::MAX_BASE) return false;
+        } else if (arg == "--zero") {
+            opts.zero = true;
+        } else if (arg == "--validate" && value(v)) {
+            opts.validatePath = v;
+        } else if (arg == "--input" && value(v)) {
+            if (!impl::bulk::parseInput(v, opts.bulk.input)) return false;
+        } else if (arg == "--output" && value(v)) {
+            opts.outputPath = v;
+        } else if (arg == "--offsets") {
+            opts.bulk.offsets = true;
+        } else if (arg == "--stream") {
+            opts.stream = true;
+        } else if (arg == "--kmin" && value(v)) {
+            opts.kMin = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--kmax" && value(v)) {
+            opts.kMax = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--progress" && value(v)) {
+            opts.progress = std::atof(v);
+            if (opts.progress <= 0) return false;
+        } else if (arg == "--checkpoint" && value(v)) {
+            opts.checkpointPath = v;
+        } else if (arg == "--checkpoint-every" && value(v)) {
+            opts.checkpointEvery = std::atof(v);
+            if (opts.checkpointEvery <= 0) return false;
+        } else if (arg == "--cache" && value(v)) {
+            opts.cachePath = v;
+        } else if (arg == "--processes" && value(v)) {
+            opts.processes = static_cast<unsigned>(std::max(1, std::atoi(v)));
+        } else if (arg == "--shards" && value(v)) {
+            opts.shards = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--engine" && value(v)) {
+            opts.engine = v;
+        } else if (arg == "--socket" && value(v)) {
+            opts.socketPath = v;
+        } else if (arg == "--join" && value(v)) {
+            opts.joinPath = v;
+        } else if (arg == "--serve" && value(v)) {
+            opts.servePath = v;
+        } else if (arg == "--autotune") {
+            opts.autotune = true;
+        } else if (arg == "--profile" && value(v)) {
+            opts.profilePath = v;
+        } else if (arg == "--no-profile") {
+            opts.noProfile = true;
+        } else if (arg == "--format" && value(v)) {
+            if (!bench::parseFormat(v, opts.bench.format)) return false;
+        } else {
+            return false;
+        }
+    }
+    if (opts.autotune && opts.noProfile) return false;
+    if (opts.servePath) {
+        return !opts.enumeratePath && opts.top == 0 && opts.base == 0 && !opts.validatePath &&
+               !opts.stream && opts.processes == 0 && !opts.joinPath && !opts.cachePath && !opts.autotune;
+    }
+    if (opts.cachePath && (!opts.stream || opts.checkpointPath || opts.processes > 0)) return false;
+    if (opts.validatePath) {
+        opts.bulk.zero = opts.zero;
+        return opts.base == 0;
+    }
+    if (opts.stream || opts.processes > 0) {
+        if (opts.base == 0) opts.base = 10;
+        return impl::stream::supported(opts.base) && opts.kMin <= opts.kMax;
+    }
+    if (opts.zero) {
+        if (opts.base == 0) opts.base = 10;
+        if (!impl::radix::supported(opts.base, true)) return false;
+    }
+    return true;
 }
 
 /**
- * @brief Benchmarks a function with multiple iterations
- * @param func Function to benchmark
- * @param iterations Number of iterations to run
- * @return Tuple of (average time, result, consistency check)
+ * @brief Streams every hit with k in [1, maxK] to opts.enumeratePath
+ * @return Process exit code
  */
-template<typename Func>
-auto benchmark(Func&& func, int iterations = 5) {
-    std::vector<double> times;
-    std::vector<impl::CalcResult> results;
-    
-    for (int i = 0; i < iterations; ++i) {
-        auto start = std::chrono::high_resolution_clock::now();
-        auto result = func();
-        auto end = std::chrono::high_resolution_clock::now();
-        
-        std::chrono::duration<double, std::milli> duration = end - start;
-        times.push_back(duration.count());
-        results.push_back(result);
-    }
-    
-    double avgTime = std::accumulate(times.begin(), times.end(), 0.0) / iterations;
-    bool allSame = std::adjacent_find(results.begin(), results.end(),
-        [](const auto& a, const auto& b) { 
-            return a.maxVal != b.maxVal || a.bestK != b.bestK || a.bestN != b.bestN; 
-        }) == results.end();
-    
-    return std::make_tuple(avgTime, results[0], allSame);
+int runEnumerate(const Options& opts, int maxK) {
+    const bool text = std::string(opts.enumeratePath) == "-";
+    std::ostream& log = text ? std::cerr : std::cout;
+
+    const auto& engine = impl::dispatch::enumerator();
+    auto& pool = impl::parallel::defaultPool();
+    log << "Enumerating hits with " << engine.name << " on " << pool.size()
+        << " threads" << (opts.sorted ? " (sorted)" : "") << std::endl;
+
+    std::unique_ptr<impl::hits::BinaryWriter> writer;
+    impl::hits::Sink sink;
+    if (text) {
+        sink = [](const impl::hits::Hit* h, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                std::cout << h[i].value << ' ' << h[i].k << ' ' << h[i].n << '\n';
+            }
+        };
+    } else {
+        writer = std::make_unique<impl::hits::BinaryWriter>(opts.enumeratePath);
+        sink = [&writer](const impl::hits::Hit* h, size_t count) { writer->write(h, count); };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t count;
+    if (opts.sorted) {
+        auto all = impl::parallel::collect(pool, engine.enumerate, 1, maxK);
+        sink(all.data(), all.size());
+        count = all.size();
+    } else {
+        count = impl::parallel::enumerate(pool, engine.enumerate, 1, maxK, sink);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (writer && !writer->ok()) {
+        std::cerr << "Could not write " << opts.enumeratePath << std::endl;
+        return 1;
+    }
+    log << count << " hits written to " << opts.enumeratePath << " in "
+        << std::fixed << std::setprecision(3) << ms << " ms" << std::endl;
+    return 0;
 }
 
-void printTableHeader() {
-    std::cout << std::setfill('-') << std::setw(80) << "-" << std::endl;
-    std::cout << std::setfill(' ')
-              << std::left << std::setw(20) << "Implementation"
-              << std::right << std::setw(15) << "Max Value"
-              << std::setw(10) << "Best K"
-              << std::setw(10) << "Best N"
-              << std::setw(15) << "Time (ms)"
-              << std::setw(10) << "Valid" << std::endl;
-    std::cout << std::setfill('-') << std::setw(80) << "-" << std::endl;
-    std::cout << std::setfill(' ');
+/**
+ * @brief Prints the opts.top largest hits with k in [1, maxK]
+ * @return Process exit code
+ */
+int runTopK(const Options& opts, int maxK) {
+    const auto& engine = impl::dispatch::ranker();
+    auto& pool = impl::parallel::defaultPool();
+
+    auto start = std::chrono::steady_clock::now();
+    auto best = impl::parallel::topK(pool, engine.topK, static_cast<size_t>(opts.top), 1, maxK);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Top " << opts.top << " with " << engine.name << " on " << pool.size()
+              << " threads (" << best.size() << " found, " << std::fixed << std::setprecision(3)
+              << ms << " ms):\n" << std::endl;
+    std::cout << std::setw(6) << "Rank" << std::setw(12) << "Value"
+              << std::setw(8) << "k" << std::setw(4) << "n" << std::endl;
+    for (size_t i = 0; i < best.size(); ++i) {
+        std::cout << std::setw(6) << i + 1 << std::setw(12) << best[i].value
+                  << std::setw(8) << best[i].k << std::setw(4) << best[i].n << std::endl;
+    }
+    return 0;
 }
 
-void printTableRow(const std::string& name, const impl::CalcResult& result, 
-                  double time, bool consistent) {
-    std::cout << std::left << std::setw(20) << name
-              << std::right << std::setw(15) << result.maxVal
-              << std::setw(10) << result.bestK
-              << std::setw(10) << result.bestN
-              << std::fixed << std::setprecision(3)
-              << std::setw(15) << time
-              << std::setw(10) << (consistent ? "Yes" : "No") << std::endl;
+/**
+ * @brief Prints the largest base-opts.base pandigital concatenated product
+ * @return Process exit code
+ */
+int runBase(const Options& opts) {
+    const int base = opts.base;
+    std::cout << "Base " << base << (opts.zero ? " (digits 0.." : " (digits 1..")
+              << impl::radix::toString(base - 1, base) << "): k = 1.."
+              << impl::radix::maxK(base, opts.zero) << " with the "
+              << impl::radix::kernelName() << " kernel on "
+              << impl::parallel::defaultPool().size() << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    impl::CalcResult r = impl::radix::calc(base, opts.zero);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (r.maxVal == 0) {
+        std::cout << "No base-" << base << " pandigital concatenated product exists" << std::endl;
+    } else {
+        std::cout << "Largest: " << impl::radix::toString(r.maxVal, base) << " (base " << base
+                  << ") = " << r.maxVal << ", k = " << impl::radix::toString(r.bestK, base)
+                  << " (" << r.bestK << "), n = " << r.bestN << std::endl;
+    }
+    std::cout << "Time: " << std::fixed << std::setprecision(3) << ms << " ms" << std::endl;
+    return 0;
 }
 
-int main() {
-    std::cout << "Program starting...\n" << std::endl;
+// Set by SIGINT / SIGTERM; the streaming search polls it between chunks
+std::atomic<bool> cancelRequested{false};
+
+extern "C" void onInterrupt(int) {
+    cancelRequested.store(true);
+}
+
+/**
+ * @brief Runs the base-opts.base search on the streaming engine
+ * @return Process exit code (130 if interrupted)
+ *
+ * With --checkpoint, SIGTERM (batch preemption) stops the search the same
+ * way as Ctrl+C and the final checkpoint lets the next run resume. With
+ * --cache, only the intervals missing from the cache file are searched.
+ */
+int runStream(const Options& opts) {
+    const int base = opts.base;
+    const uint64_t kEnd = std::min(opts.kMax, impl::stream::maxK(base, opts.zero));
+    // A fully cached query never starts the pool
+    const unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "Streaming base " << base << (opts.zero ? " (digits 0.." : " (digits 1..")
+              << impl::radix::toString(base - 1, base) << "): k = " << opts.kMin << ".." << kEnd
+              << " with the " << impl::stream::kernelName() << " kernel on " << threads
+              << " threads" << std::endl;
+
+    std::unique_ptr<impl::cache::ResultCache> cache;
+    if (opts.cachePath) {
+        cache = std::make_unique<impl::cache::ResultCache>(opts.cachePath);
+        if (!cache->ok()) {
+            std::cerr << "Cannot use " << opts.cachePath << " as a result cache: " << cache->error() << std::endl;
+            return 1;
+        }
+    }
+
+    impl::stream::Options options;
+    options.interval = opts.progress;
+    options.cancel = &cancelRequested;
+    options.checkpoint = opts.checkpointPath;
+    options.checkpointInterval = opts.checkpointEvery;
+    options.progress = [](const impl::stream::Progress& p) {
+        std::cerr << "  " << std::fixed << std::setprecision(1) << p.seconds << " s: "
+                  << p.done << " / " << p.total << " k (" << std::setprecision(1)
+                  << (p.total ? 100.0 * p.done / p.total : 100.0) << "%, "
+                  << std::setprecision(1) << p.rate() / 1e6 << " M k/s)";
+        if (p.best.maxVal != 0) std::cerr << ", best " << p.best.maxVal;
+        std::cerr << std::endl;
+    };
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    impl::cache::Outcome cached;
+    if (cache) {
+        cached = impl::cache::search(*cache, nullptr, base, opts.zero, opts.kMin, opts.kMax, options);
+    } else {
+        cached.search = impl::stream::search(impl::parallel::defaultPool(), base, opts.zero,
+                                             opts.kMin, opts.kMax, options);
+    }
+    const impl::stream::Outcome& out = cached.search;
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+
+    if (cache) {
+        std::cout << "Cache: " << cached.cached << " of " << out.total << " k values from "
+                  << cached.hits << " summaries in " << opts.cachePath << std::endl;
+        if (cached.writeFailed) {
+            std::cerr << "Warning: could not append to the result cache " << opts.cachePath << std::endl;
+        }
+    }
+
+    if (out.error) {
+        std::cerr << "Could not resume from " << opts.checkpointPath << ": " << out.error << std::endl;
+        return 1;
+    }
+    if (out.checkpointFailed) {
+        std::cerr << "Warning: could not write checkpoint " << opts.checkpointPath << std::endl;
+    }
+    if (out.resumed > 0) {
+        std::cout << "Resumed from " << opts.checkpointPath << " with " << out.resumed
+                  << " k values already searched" << std::endl;
+    }
+
+    const impl::stream::Result& r = out.result;
+    if (out.cancelled) {
+        std::cout << "Interrupted after " << out.searched << " of " << out.total << " k values" << std::endl;
+    }
+    if (r.maxVal == 0) {
+        std::cout << "No base-" << base << " pandigital concatenated product found" << std::endl;
+    } else {
+        std::cout << (out.cancelled ? "Largest so far: " : "Largest: ")
+                  << impl::radix::toString(r.maxVal, base) << " (base " << base << ") = " << r.maxVal
+                  << ", k = " << impl::radix::toString(r.bestK, base) << " (" << r.bestK
+                  << "), n = " << r.bestN << std::endl;
+    }
+    std::cout << "Time: " << std::fixed << std::setprecision(3) << out.seconds * 1e3 << " ms" << std::endl;
+    return out.cancelled ? 130 : 0;
+}
+
+/**
+ * @brief Runs the query service on opts.servePath until SIGINT / SIGTERM
+ * @return Process exit code
+ */
+int runServe(const Options& opts) {
+    if (!impl::service::available()) {
+        std::cerr << "The query service needs Unix domain sockets" << std::endl;
+        return 1;
+    }
+    impl::service::Options options;
+    options.socketPath = opts.servePath;
+    options.stop = &cancelRequested;
+    options.log = [](const std::string& message) { std::cerr << "  " << message << std::endl; };
+
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    std::cout << "Serving queries on " << options.socketPath << " (Ctrl+C to stop)" << std::endl;
+    std::string error;
+    const bool ok = impl::service::serve(impl::parallel::defaultPool(), options, error);
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    if (!ok) {
+        std::cerr << "Cannot serve on " << options.socketPath << ": " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Stopped" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Runs the search on opts.processes worker processes
+ * @return Process exit code
+ */
+int runShards(const Options& opts) {
+    impl::shard::Job job;
+    job.engine = opts.engine;
+    job.base = opts.base;
+    job.zero = opts.zero;
+    job.kBegin = opts.kMin;
+    job.kEnd = opts.kMax;
+
+    impl::shard::Options options;
+    options.processes = opts.processes;
+    options.shards = opts.shards;
+    options.socketPath = opts.socketPath;
+    options.log = [](const std::string& message) { std::cerr << "  " << message << std::endl; };
+
+    std::cout << "Sharding base " << job.base << (job.zero ? " (digits 0.." : " (digits 1..")
+              << impl::radix::toString(job.base - 1, job.base) << ") with the " << job.engine
+              << " engine on " << options.processes << " processes" << std::endl;
+    impl::shard::Outcome out = impl::shard::coordinate(job, options);
+    if (!out.error.empty()) {
+        std::cerr << "Sharded search failed: " << out.error << std::endl;
+        return 1;
+    }
+
+    const impl::stream::Result& r = out.result;
+    if (r.maxVal == 0) {
+        std::cout << "No base-" << job.base << " pandigital concatenated product found" << std::endl;
+    } else {
+        std::cout << "Largest: " << impl::radix::toString(r.maxVal, job.base) << " (base " << job.base
+                  << ") = " << r.maxVal << ", k = " << impl::radix::toString(r.bestK, job.base)
+                  << " (" << r.bestK << "), n = " << r.bestN << std::endl;
+    }
+    std::cout << out.searched << " k values in " << out.shards << " shards";
+    if (out.reassigned > 0) {
+        std::cout << ", " << out.reassigned << " reassigned, " << out.respawned << " workers replaced";
+    }
+    std::cout << "\nTime: " << std::fixed << std::setprecision(3) << out.seconds * 1e3 << " ms" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Validates every candidate in opts.validatePath
+ * @return Process exit code
+ */
+int runValidate(const Options& opts) {
+    const bool toStdout = opts.outputPath && std::string(opts.outputPath) == "-";
+    std::ostream& log = toStdout ? std::cerr : std::cout;
+
+    impl::io::MappedFile input(opts.validatePath);
+    if (!input.ok()) {
+        std::cerr << "Could not map " << opts.validatePath << ": " << input.error() << std::endl;
+        return 1;
+    }
+
+    std::FILE* out = nullptr;
+    if (opts.outputPath) {
+        out = toStdout ? stdout : std::fopen(opts.outputPath, "wb");
+        if (!out) {
+            std::cerr << "Could not open " << opts.outputPath << std::endl;
+            return 1;
+        }
+    }
+    bool failed = false;
+    impl::bulk::Sink sink = [out, &failed](const char* bytes, size_t length) {
+        if (out && std::fwrite(bytes, 1, length, out) != length) failed = true;
+    };
+
+    auto& pool = impl::parallel::defaultPool();
+    auto start = std::chrono::steady_clock::now();
+    impl::bulk::Stats stats = impl::bulk::run(pool, input.data(), input.size(), opts.bulk, sink);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (out && out != stdout && std::fclose(out) != 0) failed = true;
+    if (out == stdout) std::fflush(stdout);
+    if (failed) {
+        std::cerr << "Could not write " << opts.outputPath << std::endl;
+        return 1;
+    }
+
+    log << stats.matches << " of " << stats.records << " candidates are "
+        << (opts.zero ? "0-9" : "1-9") << " pandigital (" << input.size() << " bytes, "
+        << stats.kernel << " on " << pool.size() << " threads, " << std::fixed << std::setprecision(3)
+        << ms << " ms, " << std::setprecision(2) << (ms > 0 ? input.size() / (ms * 1e6) : 0.0)
+        << " GB/s)" << std::endl;
+    return 0;
+}
+
+/// "engine avx512, unroll 4, chunk 1024" for the log
+std::string describe(const impl::tuning::Profile& profile) {
+    std::string text = "engine " + profile.engine;
+    const impl::dispatch::Engine* engine = impl::dispatch::find(profile.engine.c_str());
+    if (engine && engine->calcUnrolled) text += ", unroll " + std::to_string(profile.unroll);
+    return text + ", chunk " + std::to_string(profile.chunk);
+}
+
+/**
+ * @brief Measures the candidates on this host, applies the winner and saves it to path
+ * @return false if the profile could not be written
+ */
+bool autotune(const std::string& path, std::ostream& log, impl::tuning::Profile& profile) {
+    log << "Autotuning on " << impl::cpu::brand() << ":" << std::endl;
+    impl::tuning::Options options;
+    options.log = [&log](const std::string& line) { log << "  " << line << std::endl; };
+    profile = impl::tuning::tune(impl::parallel::defaultPool(), options);
+    impl::tuning::apply(profile);
+    log << "Fastest: " << describe(profile) << std::endl;
+    if (!impl::tuning::save(path, profile)) {
+        log << "Could not write the tuning profile " << path << "\n" << std::endl;
+        return false;
+    }
+    log << "Saved the tuning profile to " << path << "\n" << std::endl;
+    return true;
+}
+
+/**
+ * @brief Applies this host's entry of the profile at path
+ * @return Load::Ok if it is in effect; an entry that does not apply on
+ *         this host (e.g. an unknown engine) counts as NoEntry
+ */
+impl::tuning::Load loadProfile(const std::string& path, impl::tuning::Profile& profile) {
+    impl::tuning::Load state = impl::tuning::load(path, impl::tuning::hostKey(), profile);
+    if (state == impl::tuning::Load::Corrupt) {
+        std::cerr << "Ignoring unreadable tuning profile " << path << std::endl;
+    } else if (state == impl::tuning::Load::Ok && !impl::tuning::apply(profile)) {
+        std::cerr << "Ignoring tuning profile entry (" << describe(profile)
+                  << ") that does not apply to this host" << std::endl;
+        state = impl::tuning::Load::NoEntry;
+    }
+    return state;
+}
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts) || opts.help) {
+        printUsage(argv[0]);
+        return opts.help ? 0 : 1;
+    }
+
+    if (opts.joinPath) {
+        if (impl::shard::work(opts.joinPath)) return 0;
+        std::cerr << "Lost the coordinator at " << opts.joinPath << std::endl;
+        return 1;
+    }
+
+    const std::string profilePath = opts.profilePath ? opts.profilePath : impl::tuning::defaultPath();
+    impl::tuning::Profile profile;
+    if (opts.autotune) return autotune(profilePath, std::cout, profile) ? 0 : 1;
+    impl::tuning::Load profileState = impl::tuning::Load::Missing;
+    if (!opts.noProfile) profileState = loadProfile(profilePath, profile);
+
+    if (opts.servePath) {
+        try {
+            return runServe(opts);
+        } catch (const std::exception& e) {
+            std::cerr << "Query service failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    constexpr int MAX_K = 9999;
+    if (opts.enumeratePath || opts.top > 0 || opts.base > 0 || opts.validatePath) {
+        try {
+            if (opts.validatePath) return runValidate(opts);
+            if (opts.processes > 0) return runShards(opts);
+            if (opts.stream) return runStream(opts);
+            if (opts.base > 0) return runBase(opts);
+            if (opts.top > 0) return runTopK(opts, MAX_K);
+            return runEnumerate(opts, MAX_K);
+        } catch (const std::exception& e) {
+            std::cerr << "Search failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Machine-readable formats own stdout; progress goes to stderr
+    const bool table = opts.bench.format == bench::Format::Table;
+    std::ostream& log = table ? std::cout : std::cerr;
+
+    log << "Program starting...\n" << std::endl;
+
+    bool failed = false;   // Any engine wrong, inconsistent or throwing
 
     try {
-        std::vector<std::pair<std::string, std::function<impl::CalcResult()>>> implementations;
-        implementations.push_back({"Simple", impl::simple::calc});  // Add this line
-        implementations.push_back({"Base SIMD", impl::base_simd::calc});
-        implementations.push_back({"AVX2", impl::avx2::calc});
+        // First run on this host: measure before anything reads the selection
+        if (!opts.noProfile && (profileState == impl::tuning::Load::Missing ||
+                                profileState == impl::tuning::Load::NoEntry)) {
+            autotune(profilePath, log, profile);
+            profileState = impl::tuning::Load::Ok;
+        }
 
-        bool hasAVX512 = check_cpu_features(true);
-        if (hasAVX512) {
-            implementations.push_back({"AVX-512", impl::avx512::calc});
+        const auto& features = impl::cpu::features();
+        const auto& dispatched = impl::dispatch::selected();
+        log << "CPU: " << impl::cpu::brand() << std::endl;
+        log << "CPU features: " << impl::cpu::describe(features) << std::endl;
+        if (profileState == impl::tuning::Load::Ok) {
+            log << "Tuning profile: " << describe(profile) << " (" << profilePath << ")" << std::endl;
         } else {
-            std::cout << "CPU does not support AVX-512, skipping that implementation.\n" << std::endl;
+            log << "Tuning profile: none, built-in defaults" << std::endl;
         }
+        log << "Dispatched kernel: " << dispatched.name << std::endl;
+        log << "Compile-time answer: " << EXPECTED.maxVal << " (k = " << EXPECTED.bestK
+            << ", n = " << EXPECTED.bestN << ")\n" << std::endl;
 
-        std::cout << "Running implementations:\n" << std::endl;
-        printTableHeader();
+        if (opts.bench.pinCpu >= 0) {
+            if (bench::pinToCpu(opts.bench.pinCpu)) {
+                log << "Pinned benchmark thread to CPU " << opts.bench.pinCpu << std::endl;
+            } else {
+                log << "Could not pin to CPU " << opts.bench.pinCpu << ", running unpinned" << std::endl;
+            }
+        }
+
+        // Table build cost and footprint for the LUT implementations
+        auto tableStats = impl::digit_table::stats();
+        log << "Digit table: " << tableStats.entries << " entries, "
+            << tableStats.bytes << " bytes ("
+            << (tableStats.bytes <= 32 * 1024 ? "fits L1D" : "L2-resident")
+            << "), built in " << std::fixed << std::setprecision(1)
+            << tableStats.buildUs << " us\n" << std::endl;
 
+        // Dispatch table is fastest first; list slowest first
+        size_t engineCount = 0;
+        const impl::dispatch::Engine* engines = impl::dispatch::engines(engineCount);
+        std::vector<std::pair<std::string, RangeFn>> rangeKernels;
+        for (size_t i = engineCount; i-- > 0;) {
+            if (engines[i].supported(features)) {
+                rangeKernels.push_back({engines[i].name, engines[i].calcRange});
+            } else {
+                log << "CPU does not support " << engines[i].name
+                    << ", skipping that implementation." << std::endl;
+            }
+        }
+
+        std::vector<std::pair<std::string, std::function<impl::CalcResult()>>> implementations;
+        for (const auto& [name, kernel] : rangeKernels) {
+            implementations.push_back({name, [kernel] { return kernel(1, MAX_K); }});
+        }
+        implementations.push_back({"Dispatched", [] { return impl::dispatch::calc(); }});
+        implementations.push_back({"Descending", [] { return impl::descending::calc(); }});
+
+        // Only the k intervals that can still yield a new maximum
+        RangeFn dispatchedRange = [](int kBegin, int kEnd) { return impl::dispatch::calc(kBegin, kEnd); };
+        impl::planner::Report plan;
+        impl::planner::search(dispatchedRange, &plan);
+        log << "Planner: searches";
+        for (const auto& iv : plan.intervals) {
+            log << " n=" << iv.n << " k=[" << iv.kBegin << ", " << iv.kEnd << "]";
+        }
+        log << ", " << plan.eliminated() << " of " << plan.total << " k values eliminated\n" << std::endl;
+        implementations.push_back({"Planned", [dispatchedRange] {
+            return impl::planner::search(dispatchedRange);
+        }});
+
+        // Multi-threaded k-range partitioning over the same kernels
+        log << "Parallel driver uses " << impl::parallel::defaultPool().size()
+            << " threads (workers are not pinned).\n" << std::endl;
+        for (const auto& [name, kernel] : rangeKernels) {
+            implementations.push_back({name + " MT", [kernel] {
+                return impl::parallel::calc(kernel, 1, MAX_K, impl::parallel::DEFAULT_CHUNK);
+            }});
+        }
+        // Selected engine, unroll depth and chunk together
+        implementations.push_back({"Dispatched MT", [dispatchedRange] {
+            return impl::parallel::calc(dispatchedRange, 1, MAX_K);
+        }});
+
+        log << "Running implementations (" << opts.bench.warmup << " warmup, "
+            << opts.bench.iterations << " samples each):\n" << std::endl;
+
+        // Hardware counters are optional: fall back to timing only
+        std::unique_ptr<bench::perf::CounterSet> counters;
+        if (opts.bench.perf) {
+            counters = std::make_unique<bench::perf::CounterSet>();
+            if (!counters->usable()) {
+                log << "Hardware counters unavailable: " << counters->status()
+                    << "; reporting timings only.\n" << std::endl;
+                counters.reset();
+            } else if (!counters->status().empty()) {
+                log << "Hardware counters: " << counters->status() << "\n" << std::endl;
+            }
+        }
+
+        std::vector<bench::Measurement> rows;
         for (const auto& [name, func] : implementations) {
             try {
-                auto [avgTime, result, consistent] = benchmark(func);
-                printTableRow(name, result, avgTime, consistent);
+                rows.push_back(bench::run(name, func, MAX_K, opts.bench, counters.get()));
             } catch (const std::exception& e) {
-                std::cout << name << " failed: " << e.what() << std::endl;
+                log << name << " failed: " << e.what() << std::endl;
+                failed = true;
             } catch (...) {
-                std::cout << name << " failed with unknown exception" << std::endl;
+                log << name << " failed with unknown exception" << std::endl;
+                failed = true;
+            }
+        }
+        for (const auto& m : rows) {
+            const auto& r = m.result;
+            if (r.maxVal != EXPECTED.maxVal || r.bestK != EXPECTED.bestK || r.bestN != EXPECTED.bestN) {
+                log << m.name << " returned " << r.maxVal << " (k = " << r.bestK << ", n = " << r.bestN
+                    << "), expected " << EXPECTED.maxVal << " from the compile-time search" << std::endl;
+                failed = true;
+            } else if (!m.consistent) {
+                log << m.name << " returned different results across calls" << std::endl;
+                failed = true;
             }
         }
 
-        std::cout << std::setfill('-') << std::setw(80) << "-" << std::endl;
+        bench::HostInfo host{impl::cpu::brand(), impl::cpu::describe(features),
+                             dispatched.name, impl::parallel::defaultPool().size()};
+        switch (opts.bench.format) {
+            case bench::Format::Json: bench::printJson(std::cout, host, opts.bench, rows); break;
+            case bench::Format::Csv: bench::printCsv(std::cout, host, rows); break;
+            default: bench::printTable(std::cout, rows); break;
+        }
 
     } catch (const std::exception& e) {
         std::cout << "Main exception: " << e.what() << std::endl;
+        failed = true;
     } catch (...) {
         std::cout << "Unknown main exception occurred" << std::endl;
+        failed = true;
     }
 
-    return 0;
-}
\ No newline at end of file
+    // A wrong or inconsistent engine fails scripted runs
+    return failed ? 2 : 0;
+}
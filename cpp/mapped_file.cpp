@@ -0,0 +1,96 @@
+/**
+ * @file mapped_file.cpp
+ * @brief POSIX and Windows implementations of MappedFile
+ */
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace impl::io {
+#if defined(_WIN32)
+    MappedFile::MappedFile(const char* path) {
+        HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            message = "cannot open file";
+            return;
+        }
+        file = h;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(h, &size)) {
+            message = "cannot read file size";
+            return;
+        }
+        length = static_cast<size_t>(size.QuadPart);
+        if (length == 0) {
+            valid = true;
+            return;
+        }
+
+        mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            message = "CreateFileMapping failed";
+            return;
+        }
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!bytes) {
+            message = "MapViewOfFile failed";
+            return;
+        }
+        valid = true;
+    }
+
+    MappedFile::~MappedFile() {
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file) CloseHandle(file);
+    }
+#else
+    MappedFile::MappedFile(const char* path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            message = std::strerror(errno);
+            return;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            message = std::strerror(errno);
+            close(fd);
+            return;
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) {
+            close(fd);
+            valid = true;
+            return;
+        }
+
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);   // The mapping keeps the file referenced
+        if (p == MAP_FAILED) {
+            message = std::strerror(errno);
+            length = 0;
+            return;
+        }
+        // One forward pass: let the kernel read ahead aggressively
+        madvise(p, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(p);
+        valid = true;
+    }
+
+    MappedFile::~MappedFile() {
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+}
@@ -0,0 +1,45 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory mapping of a whole file
+ *
+ * mmap on POSIX, CreateFileMapping / MapViewOfFile on Windows. The
+ * mapping is page-aligned, so 4- and 8-byte records in it are aligned.
+ * An empty file maps to data() == nullptr with size() == 0.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace impl::io {
+    /**
+     * @class MappedFile
+     * @brief RAII read-only view of a file
+     */
+    class MappedFile {
+    public:
+        /// Maps path; check ok() and error() afterwards
+        explicit MappedFile(const char* path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool ok() const { return valid; }
+        const std::string& error() const { return message; }
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+
+    private:
+        const char* bytes = nullptr;
+        size_t length = 0;
+        bool valid = false;
+        std::string message;
+#if defined(_WIN32)
+        void* file = nullptr;
+        void* mapping = nullptr;
+#endif
+    };
+}
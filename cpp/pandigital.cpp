@@ -0,0 +1,77 @@
+/**
+ * @file pandigital.cpp
+ * @brief Public API on top of the batch kernels and the engine dispatch
+ *
+ * Compiled without ISA flags, like dispatch.cpp and radix.cpp: it only
+ * checks the CPU once and forwards to the kernel libraries.
+ */
+#include "pandigital.h"
+#include "batch.h"
+#include "cpu_features.h"
+#include "dispatch.h"
+
+namespace pandigital {
+    namespace {
+        /**
+         * @struct Kernels
+         * @brief Batch functions of one instruction set
+         */
+        struct Kernels {
+            void (*validate32)(const uint32_t*, size_t, uint8_t*, bool);
+            void (*validate64)(const uint64_t*, size_t, uint8_t*, bool);
+            void (*classify)(const uint32_t*, size_t, Product*);
+            const char* name;
+        };
+
+        const Kernels& kernels() {
+            namespace batch = impl::batch;
+            static const Kernels chosen = [] {
+                const auto& f = impl::cpu::features();
+                if (f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl) {
+                    return Kernels{batch::avx512::validate, batch::avx512::validate,
+                                   batch::avx512::classify, "AVX-512"};
+                }
+                if (f.avx2) {
+                    return Kernels{batch::avx2::validate, batch::avx2::validate,
+                                   batch::avx2::classify, "AVX2"};
+                }
+                return Kernels{batch::scalar::validate, batch::scalar::validate,
+                               batch::scalar::classify, "Scalar"};
+            }();
+            return chosen;
+        }
+    }
+
+    void validate_batch(const uint32_t* values, size_t count, uint8_t* out, Digits digits) {
+        kernels().validate32(values, count, out, digits == Digits::ZeroToNine);
+    }
+
+    void validate_batch(const uint64_t* values, size_t count, uint8_t* out, Digits digits) {
+        kernels().validate64(values, count, out, digits == Digits::ZeroToNine);
+    }
+
+    bool is_pandigital(uint64_t value, Digits digits) {
+        uint8_t flag;
+        impl::batch::scalar::validate(&value, 1, &flag, digits == Digits::ZeroToNine);
+        return flag != 0;
+    }
+
+    void classify_batch(const uint32_t* values, size_t count, Product* out) {
+        kernels().classify(values, count, out);
+    }
+
+    Product classify(uint32_t value) {
+        Product p;
+        impl::batch::scalar::classify(&value, 1, &p);
+        return p;
+    }
+
+    Result largest() {
+        impl::CalcResult r = impl::dispatch::calc();
+        return {r.maxVal, static_cast<uint32_t>(r.bestK), static_cast<uint32_t>(r.bestN)};
+    }
+
+    const char* kernel_name() {
+        return kernels().name;
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file pandigital.h
+ * @brief Public library API: batch validation and product classification
+ *
+ * Stable entry points for linking the kernels into other programs
+ * (target pandigital_lib). Only plain integer types cross this header;
+ * the SIMD kernel is picked once per process from the CPU features
+ * (AVX-512, AVX2 or portable scalar), like the engine dispatch table.
+ *
+ * All batch functions are thread-safe, allocate nothing and accept
+ * unaligned buffers of any length.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pandigital {
+    /// Which digits a pandigital must contain exactly once
+    enum class Digits : uint8_t {
+        OneToNine,    ///< 1..9, nine digits (e.g. 932718654)
+        ZeroToNine,   ///< 0..9, ten digits without a leading zero (e.g. 4865197302)
+    };
+
+    /**
+     * @struct Product
+     * @brief Decomposition value = k*1 || k*2 || ... || k*n
+     *
+     * n == 0 (and k == 0) if the value is no concatenated product with n >= 2.
+     */
+    struct Product {
+        uint32_t k;
+        uint32_t n;
+    };
+
+    /**
+     * @struct Result
+     * @brief Largest pandigital concatenated product
+     */
+    struct Result {
+        uint64_t value;
+        uint32_t k;
+        uint32_t n;
+    };
+
+    /**
+     * @brief out[i] = 1 if values[i] is pandigital, else 0
+     * @param values Candidates
+     * @param count Number of candidates
+     * @param out count bytes
+     * @param digits Digit set
+     */
+    void validate_batch(const uint32_t* values, size_t count, uint8_t* out,
+                        Digits digits = Digits::OneToNine);
+
+    /// 64-bit variant of validate_batch
+    void validate_batch(const uint64_t* values, size_t count, uint8_t* out,
+                        Digits digits = Digits::OneToNine);
+
+    /// Single-value validation
+    bool is_pandigital(uint64_t value, Digits digits = Digits::OneToNine);
+
+    /**
+     * @brief out[i] = decomposition of values[i] as k*1 || ... || k*n
+     *
+     * Any value is accepted, pandigital or not, e.g. 192384576 gives
+     * k = 192, n = 3 and 1224 gives k = 12, n = 2. If several k work, the
+     * smallest is reported.
+     */
+    void classify_batch(const uint32_t* values, size_t count, Product* out);
+
+    /// Single-value classification
+    Product classify(uint32_t value);
+
+    /// Largest 1-9 pandigital concatenated product (Project Euler 38)
+    Result largest();
+
+    /// Kernel behind the batch functions ("AVX-512", "AVX2" or "Scalar")
+    const char* kernel_name();
+}
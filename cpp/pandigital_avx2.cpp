@@ -21,9 +21,14 @@
 #include <immintrin.h>
 #include <iostream>
 #include <algorithm>
+#include <vector>
 #include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
 
 namespace impl::avx2 {
+    constexpr int MAX_K = 9999;
+
     // Precomputed powers of ten for up to 9 digits
     static constexpr int POW10[10] = {1,10,100,1000,10000,100000,1000000,10000000,100000000,1000000000};
 
@@ -34,74 +39,113 @@ namespace impl::avx2 {
         return cnt;
     }
 
-    // Concatenate p1 and p2 into a single integer.
-    inline int concatProducts(int p1, int p2) {
-        int d2 = digitCount(p2);
-        return p1 * POW10[d2] + p2;
-    }
-
-    // Check if p1 and p2 together form a 1–9 pandigital using bitmask
-    inline bool isPandigitalMask(int p1, int p2) {
-        int mask = 0;
-        // mask digits of p1
-        while (p1) {
-            int d = p1 % 10;
+    // Fold the digits of p into a running 1-9 bitmask.
+    // Returns false if p contains a 0 or a digit already present in mask.
+    inline bool isPandigitalMask(int p, int& mask) {
+        while (p) {
+            int d = p % 10;
             if (d == 0 || (mask & (1 << d))) return false;
             mask |= (1 << d);
-            p1 /= 10;
-        }
-        // mask digits of p2
-        while (p2) {
-            int d = p2 % 10;
-            if (mask & (1 << d)) return false;
-            mask |= (1 << d);
-            p2 /= 10;
+            p /= 10;
         }
-        // full mask for digits 1-9 is bits 1-9 set => 0x3FE
-        return mask == 0x3FE;
+        return true;
     }
 
-    // Process a batch of up to 8 k values starting at kStart
-    void processBatch(int kStart, int batchSize, CalcResult& result) {
+    // Process a batch of up to 8 k values starting at kStart; onHit(value, k, n)
+    // receives every hit, in k order
+    template <typename OnHit>
+    void processBatch(int kStart, int batchSize, OnHit&& onHit) {
+        constexpr int MAX_N = 9;
         alignas(64) int kArr[8];
-        alignas(64) int prod1[8];
-        alignas(64) int prod2[8];
+        alignas(64) int prod[MAX_N][8];
         // Prepare k values
         for (int i = 0; i < batchSize; ++i) kArr[i] = kStart + i;
         for (int i = batchSize; i < 8; ++i) kArr[i] = 0;
 
         __m256i kVec = _mm256_loadu_si256(reinterpret_cast<__m256i *>(kArr));
-        __m256i two  = _mm256_set1_epi32(2);
-        __m256i v1   = kVec;
-        __m256i v2   = _mm256_mullo_epi32(kVec, two);
-        _mm256_store_si256(reinterpret_cast<__m256i *>(prod1), v1);
-        _mm256_store_si256(reinterpret_cast<__m256i *>(prod2), v2);
+        for (int n = 1; n <= MAX_N; ++n) {
+            __m256i v = _mm256_mullo_epi32(kVec, _mm256_set1_epi32(n));
+            _mm256_store_si256(reinterpret_cast<__m256i *>(prod[n - 1]), v);
+        }
 
 #pragma omp simd
         for (int i = 0; i < batchSize; ++i) {
-            int p1 = prod1[i];
-            int p2 = prod2[i];
-            // quick length check
-            int concat = concatProducts(p1, p2);
-            if (concat < 100000000 || concat > 999999999) continue;
-            // mask-based pandigital check
-            if (isPandigitalMask(p1, p2) && concat > result.maxVal) {
-                result.maxVal = concat;
-                result.bestK = kArr[i];
+            // Carry the concatenation, its digit count and digit mask
+            // across multipliers instead of rebuilding them per n.
+            int concat = 0;
+            int digits = 0;
+            int mask = 0;
+            for (int n = 1; n <= MAX_N; ++n) {
+                int p = prod[n - 1][i];
+                int d = digitCount(p);
+                // quick length check
+                if (digits + d > 9) break;
+                // mask-based pandigital check
+                if (!isPandigitalMask(p, mask)) break;
+                concat = concat * POW10[d] + p;
+                digits += d;
+                if (digits == 9) {
+                    // full mask for digits 1-9 is bits 1-9 set => 0x3FE
+                    if (n >= 2 && mask == 0x3FE) onHit(concat, kArr[i], n);
+                    break;
+                }
             }
         }
     }
 
-    CalcResult calc() {
-        constexpr int MAX_K = 9999;
-        CalcResult result = {0, 0, 2}; // Initialize with maxVal=0, bestK=0, bestN=2
+    // Search k in [kBegin, kEnd]; k above MAX_K cannot give 9 digits with n >= 2
+    CalcResult calc(int kBegin, int kEnd) {
+        CalcResult result = {0, 0, 0}; // Initialize with maxVal=0, bestK=0, bestN=0
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
 
         // Process k in batches of 8
-        for (int k = 1; k <= MAX_K; k += 8) {
-            int batchSize = std::min(8, MAX_K - k + 1);
-            processBatch(k, batchSize, result);
+        auto keepBest = [&result](int value, int k, int n) {
+            if (static_cast<uint64_t>(value) > result.maxVal) {
+                result.maxVal = value;
+                result.bestK = k;
+                result.bestN = n;
+            }
+        };
+        for (int k = kBegin; k <= kEnd; k += 8) {
+            int batchSize = std::min(8, kEnd - k + 1);
+            processBatch(k, batchSize, keepBest);
         }
 
         return result;
     }
+
+    // Append every hit with k in [kBegin, kEnd] to out
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        auto push = [&out](int value, int k, int n) { out.push(value, k, n); };
+        for (int k = kBegin; k <= kEnd; k += 8) {
+            processBatch(k, std::min(8, kEnd - k + 1), push);
+        }
+    }
+
+    // Keep the best heap.capacity() hits with k in [kBegin, kEnd]
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        auto offer = [&heap](int value, int k, int n) {
+            if (value >= heap.threshold()) heap.offer({value, k, n});
+        };
+        for (int k = kBegin; k <= kEnd; k += 8) {
+            processBatch(k, std::min(8, kEnd - k + 1), offer);
+        }
+    }
+
+    // The count largest hits over k = 1..MAX_K, best first
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
 }
\ No newline at end of file
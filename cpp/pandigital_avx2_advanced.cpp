@@ -1,36 +1,34 @@
 #include <immintrin.h>
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+#include "simd_best.h"
+#include "simd_divide.h"
 
 namespace impl::avx2_advanced {
+    constexpr int MAX_K = 9999;
     constexpr int FULL_MASK = 0x3FE;
     
-    // AVX2 constants
-    static const __m256i V_TWO = _mm256_set1_epi32(2);
-    static const __m256i V_TEN = _mm256_set1_epi32(10);
-    static const __m256i V_100M = _mm256_set1_epi32(100000000);
-    static const __m256i V_1B = _mm256_set1_epi32(1000000000);
-    static const __m256i V_FULL_MASK = _mm256_set1_epi32(FULL_MASK);
-    
-    // Shift constants
-    static const __m256i V_TEN1 = _mm256_set1_epi32(10);
-    static const __m256i V_TEN2 = _mm256_set1_epi32(100);
-    static const __m256i V_TEN3 = _mm256_set1_epi32(1000);
-    static const __m256i V_TEN4 = _mm256_set1_epi32(10000);
-    static const __m256i V_SHIFT_DEFAULT = _mm256_set1_epi32(100000);
+    // Vector constants live in function scope: namespace-scope __m256i
+    // objects would execute AVX2 code during static initialization, before
+    // the dispatcher has checked the CPU.
 
+    // Digit bitmask of num; positions above the leading digit contribute nothing.
     inline __m256i compute_digit_mask(__m256i num) {
         __m256i mask = _mm256_setzero_si256();
         __m256i v = num;
         for (int i = 0; i < 5; ++i) {
-            // Get the remainder when divided by 10
-            __m256i quotient = _mm256_div_epi32(v, V_TEN);
-            __m256i product = _mm256_mullo_epi32(quotient, V_TEN);
-            __m256i remainder = _mm256_sub_epi32(v, product);
+            // Get the remainder when divided by 10 (magic-number division)
+            __m256i quotient = simd::div10_epu32(v);
+            __m256i remainder = simd::rem_epu32<10>(v, quotient);
             
             // Create a bit mask for this digit
             __m256i bit = _mm256_sllv_epi32(_mm256_set1_epi32(1), remainder);
+            bit = _mm256_and_si256(bit, _mm256_cmpgt_epi32(v, _mm256_setzero_si256()));
             mask = _mm256_or_si256(mask, bit);
             
             v = quotient;
@@ -38,68 +36,202 @@ namespace impl::avx2_advanced {
         return mask;
     }
 
-    CalcResult calc() {
-        constexpr int MAX_K = 9999;
-        constexpr int BATCH = 8;  // AVX2 has 8 32-bit lanes
-        alignas(32) int kArr[BATCH];
+    // Lane indices of the set bits of an 8-bit mask, packed one per nibble
+    // in ascending order; AVX2 has no compress, so enumerate emulates it
+    // with _mm256_permutevar8x32_epi32 driven by this table.
+    constexpr std::array<uint32_t, 256> makeCompressTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t m = 0; m < 256; ++m) {
+            uint32_t packed = 0;
+            int slot = 0;
+            for (uint32_t lane = 0; lane < 8; ++lane) {
+                if (m & (1u << lane)) packed |= lane << (4 * slot++);
+            }
+            table[m] = packed;
+        }
+        return table;
+    }
+    constexpr std::array<uint32_t, 256> COMPRESS_TABLE = makeCompressTable();
 
-        CalcResult result = {0, 0, 2};
+    // Picks lanes of v in the order given by indices (a COMPRESS_TABLE row)
+    inline __m256i compress(__m256i v, __m256i indices) {
+        return _mm256_permutevar8x32_epi32(v, indices);
+    }
+
+    // Grow k*1 || k*2 || ... per lane until the next product would exceed
+    // 9 digits; returns all-ones in lanes holding a pandigital value, n >= 2
+    inline __m256i evaluate(__m256i kVec, __m256i& concat, __m256i& nVec) {
+        constexpr int MAX_N = 9;
+
+        // AVX2 constants
+        const __m256i V_TEN = _mm256_set1_epi32(10);
+        const __m256i V_FULL_MASK = _mm256_set1_epi32(FULL_MASK);
+        const __m256i V_NINE = _mm256_set1_epi32(9);
+
+        // Shift constants
+        const __m256i V_TEN1 = _mm256_set1_epi32(10);
+        const __m256i V_TEN2 = _mm256_set1_epi32(100);
+        const __m256i V_TEN3 = _mm256_set1_epi32(1000);
+        const __m256i V_TEN4 = _mm256_set1_epi32(10000);
+        const __m256i V_SHIFT_DEFAULT = _mm256_set1_epi32(100000);
 
-        for (int k = 1; k <= MAX_K; k += BATCH) {
-            int concatArr[BATCH];
-            int bs = std::min(BATCH, MAX_K - k + 1);
-            for (int i = 0; i < bs; ++i) kArr[i] = k + i;
-            for (int i = bs; i < BATCH; ++i) kArr[i] = 0;
+        // Running concatenation, digit count, digit mask and multiplier per lane
+        concat = _mm256_setzero_si256();
+        nVec = _mm256_setzero_si256();
+        __m256i digits = _mm256_setzero_si256();
+        __m256i maskVec = _mm256_setzero_si256();
 
-            // Load and compute products
-            __m256i kVec = _mm256_load_si256(reinterpret_cast<__m256i *>(kArr));
-            __m256i p1 = kVec;
-            __m256i p2 = _mm256_mullo_epi32(kVec, V_TWO);
+        for (int n = 1; n <= MAX_N; ++n) {
+            __m256i p = _mm256_mullo_epi32(kVec, _mm256_set1_epi32(n));
 
-            // Compute shift amount based on the number of digits in p2.
+            // Compute shift amount and digit count of p.
             __m256i shift = V_SHIFT_DEFAULT;
-            __m256i cmp = _mm256_cmpgt_epi32(V_TEN1, p2);
-            shift = _mm256_blendv_epi8(shift, V_TEN1, cmp);
-            cmp = _mm256_cmpgt_epi32(V_TEN2, p2);
-            shift = _mm256_blendv_epi8(shift, V_TEN2, cmp);
-            cmp = _mm256_cmpgt_epi32(V_TEN3, p2);
-            shift = _mm256_blendv_epi8(shift, V_TEN3, cmp);
-            cmp = _mm256_cmpgt_epi32(V_TEN4, p2);
+            __m256i pDigits = _mm256_set1_epi32(5);
+            __m256i cmp = _mm256_cmpgt_epi32(V_TEN4, p);
             shift = _mm256_blendv_epi8(shift, V_TEN4, cmp);
+            pDigits = _mm256_add_epi32(pDigits, cmp);
+            cmp = _mm256_cmpgt_epi32(V_TEN3, p);
+            shift = _mm256_blendv_epi8(shift, V_TEN3, cmp);
+            pDigits = _mm256_add_epi32(pDigits, cmp);
+            cmp = _mm256_cmpgt_epi32(V_TEN2, p);
+            shift = _mm256_blendv_epi8(shift, V_TEN2, cmp);
+            pDigits = _mm256_add_epi32(pDigits, cmp);
+            cmp = _mm256_cmpgt_epi32(V_TEN1, p);
+            shift = _mm256_blendv_epi8(shift, V_TEN1, cmp);
+            pDigits = _mm256_add_epi32(pDigits, cmp);
+
+            // Lanes stop growing once another product would exceed 9 digits
+            __m256i newDigits = _mm256_add_epi32(digits, pDigits);
+            __m256i fits = _mm256_cmpgt_epi32(V_TEN, newDigits);
 
             // Concatenate numbers
-            __m256i concat = _mm256_add_epi32(
-                _mm256_mullo_epi32(p1, shift), p2);
-            _mm256_store_si256(reinterpret_cast<__m256i *>(concatArr), concat);
-
-            // Compute digit masks
-            __m256i mask1 = compute_digit_mask(p1);
-            __m256i mask2 = compute_digit_mask(p2);
-            __m256i maskVec = _mm256_or_si256(mask1, mask2);
-
-            // Compare masks and range check
-            __m256i validMask = _mm256_cmpeq_epi32(maskVec, V_FULL_MASK);
-            __m256i rangeMask = _mm256_and_si256(
-                _mm256_cmpgt_epi32(V_1B, concat),
-                _mm256_cmpgt_epi32(concat, V_100M)
-            );
-            validMask = _mm256_and_si256(validMask, rangeMask);
-
-            // Extract mask and process valid results
-            int mask = _mm256_movemask_epi8(validMask);
+            __m256i newConcat = _mm256_add_epi32(_mm256_mullo_epi32(concat, shift), p);
+            __m256i newMask = _mm256_or_si256(maskVec, compute_digit_mask(p));
+
+            concat = _mm256_blendv_epi8(concat, newConcat, fits);
+            maskVec = _mm256_blendv_epi8(maskVec, newMask, fits);
+            digits = _mm256_blendv_epi8(digits, newDigits, fits);
+            nVec = _mm256_blendv_epi8(nVec, _mm256_set1_epi32(n), fits);
+        }
+
+        // Nine digits covering bits 1-9 can only be 1-9 each exactly once
+        __m256i validMask = _mm256_and_si256(
+            _mm256_cmpeq_epi32(maskVec, V_FULL_MASK),
+            _mm256_cmpeq_epi32(digits, V_NINE)
+        );
+        return _mm256_and_si256(validMask,
+            _mm256_cmpgt_epi32(nVec, _mm256_set1_epi32(1)));
+    }
+
+    // Search k in [kBegin, kEnd]; k above MAX_K cannot give 9 digits with n >= 2.
+    // UNROLL independent batches per step hide the mullo latency of evaluate;
+    // the best lanes stay in registers until the end of the range.
+    template <int UNROLL>
+    CalcResult calcUnrolled(int kBegin, int kEnd) {
+        constexpr int BATCH = 8;  // AVX2 has 8 32-bit lanes
+        const __m256i step = _mm256_set1_epi32(UNROLL * BATCH);
+
+        CalcResult result = {0, 0, 0};
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        if (kEnd < kBegin) return result;
+
+        simd::Best8 best[UNROLL];
+        __m256i kVec[UNROLL];
+        for (int u = 0; u < UNROLL; ++u) kVec[u] = simd::kLanes8(kBegin + u * BATCH);
+        for (int k = kBegin; k <= kEnd; k += UNROLL * BATCH) {
+            for (int u = 0; u < UNROLL; ++u) {
+                __m256i concat, n;
+                __m256i valid = _mm256_and_si256(evaluate(kVec[u], concat, n), simd::inRange8(kVec[u], kEnd));
+                simd::update(best[u], valid, concat, kVec[u], n);
+                kVec[u] = _mm256_add_epi32(kVec[u], step);
+            }
+        }
+
+        for (const auto& b : best) simd::reduce(b, result);
+        return result;
+    }
+
+    // Two batches per step unless a tuning profile says otherwise
+    CalcResult calc(int kBegin, int kEnd) {
+        return calcUnrolled<2>(kBegin, kEnd);
+    }
+
+    // Same search with unroll (1, 2 or 4) batches per step
+    CalcResult calc(int kBegin, int kEnd, int unroll) {
+        switch (unroll) {
+            case 1: return calcUnrolled<1>(kBegin, kEnd);
+            case 4: return calcUnrolled<4>(kBegin, kEnd);
+            default: return calcUnrolled<2>(kBegin, kEnd);
+        }
+    }
+
+    // Append every hit in [kBegin, kEnd] to out
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        constexpr int BATCH = 8;
+        const __m256i NIBBLE_SHIFTS = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i NIBBLE = _mm256_set1_epi32(0xF);
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m256i kVec = simd::kLanes8(k);
+            __m256i concat, nVec;
+            __m256i validMask = _mm256_and_si256(evaluate(kVec, concat, nVec), simd::inRange8(kVec, kEnd));
+
+            // One bit per 32-bit lane
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(validMask)));
             if (mask) {
-                for (int i = 0; i < bs; ++i) {
-                    if (mask & (1 << (i * 4))) {
-                        int val = concatArr[i];
-                        if (val > result.maxVal) {
-                            result.maxVal = val;
-                            result.bestK = kArr[i];
-                        }
-                    }
+                __m256i indices = _mm256_and_si256(
+                    _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(COMPRESS_TABLE[mask])), NIBBLE_SHIFTS),
+                    NIBBLE);
+                // Full-width stores; lanes past the hit count land in the buffer slack
+                out.reserve(BATCH);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.values()), compress(concat, indices));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.ks()), compress(kVec, indices));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.ns()), compress(nVec, indices));
+                out.commit(hits::laneCount(mask));
+            }
+        }
+    }
+
+    // Keep the best heap.capacity() hits in [kBegin, kEnd]; lanes must
+    // reach the heap threshold in-register before they are offered
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        constexpr int BATCH = 8;
+        alignas(32) int kArr[BATCH];
+        alignas(32) int concatArr[BATCH];
+        alignas(32) int nArr[BATCH];
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m256i kVec = simd::kLanes8(k);
+            __m256i concat, nVec;
+            __m256i validMask = _mm256_and_si256(evaluate(kVec, concat, nVec), simd::inRange8(kVec, kEnd));
+            validMask = _mm256_and_si256(validMask,
+                _mm256_cmpgt_epi32(concat, _mm256_set1_epi32(heap.threshold() - 1)));
+
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(validMask));
+            if (mask) {
+                _mm256_store_si256(reinterpret_cast<__m256i *>(kArr), kVec);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(concatArr), concat);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(nArr), nVec);
+                for (int i = 0; i < BATCH; ++i) {
+                    if (mask & (1 << i)) heap.offer({concatArr[i], kArr[i], nArr[i]});
                 }
             }
         }
+    }
 
-        return result;
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
     }
 }
\ No newline at end of file
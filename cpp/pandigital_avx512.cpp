@@ -16,58 +16,77 @@
  * Optimizations:
  * - Mask-based comparisons
  * - Blend operations for conditional moves
- * - Optimized digit counting and validation
+ * - In-register digit-mask validation (reciprocal-multiply digit extraction,
+ *   _mm512_sllv_epi32 digit bits, mask-test duplicate detection)
+ * - Per-lane running maximum in registers, reduced once per range
+ * - Compress-store of every valid lane in enumerate mode
  * 
  * Performance characteristics:
  * - Maximum parallelism: 16 integers
- * - Memory usage: 192 bytes aligned buffers
- * - Reduced branch operations
+ * - Memory usage: 64 bytes aligned buffers
+ * - No per-lane branches
  */
 #include <immintrin.h>
 #include <iostream>
 #include <algorithm>
 #include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+#include "simd_best.h"
+#include "simd_divide.h"
 
 namespace impl::avx512 {
+    constexpr int MAX_K = 9999;
+
     // Precomputed pandigital mask full bits for 1–9
     constexpr int FULL_MASK = 0x3FE;
 
-    // Check mask-based pandigital for scalar fallback
-    inline bool maskPandigitalScalar(int value, int p1, int p2) {
-        int mask = 0;
-        while (p1) { int d = p1 % 10; if (d == 0 || (mask & (1<<d))) return false; mask |= 1<<d; p1/=10; }
-        while (p2) { int d = p2 % 10; if (mask & (1<<d)) return false; mask |= 1<<d; p2/=10; }
-        return mask == FULL_MASK && value >= 100000000 && value <= 999999999;
+    // Fold the digits of p (at most 5) into mask; digits already present
+    // (or a 0) set the lane in dup. Only lanes in active are touched.
+    inline void accumulateDigits(__m512i p, __mmask16 active, __m512i& mask, __mmask16& dup) {
+        const __m512i one = _mm512_set1_epi32(1);
+        __m512i v = p;
+        for (int i = 0; i < 5; ++i) {
+            __mmask16 live = _mm512_mask_test_epi32_mask(active, v, v);
+            __m512i q = simd::div10_epu32(v);
+            __m512i digit = simd::rem_epu32<10>(v, q);
+            __m512i bit = _mm512_sllv_epi32(one, digit);
+            // A bit already set in mask is a repeated digit
+            dup |= _mm512_mask_test_epi32_mask(live, mask, bit);
+            mask = _mm512_mask_or_epi32(mask, live, mask, bit);
+            v = q;
+        }
+        // 0 maps to bit 0, which must never be set
+        dup |= _mm512_mask_test_epi32_mask(active, mask, one);
     }
 
-    CalcResult calc() {
-        constexpr int MAX_K = 9999;
-        constexpr int BATCH = 16;                // AVX-512 16 lanes
-        alignas(64) int kArr[BATCH];
-        alignas(64) int concatArr[BATCH];
-
-        CalcResult result = {0, 0, 2}; // Initialize with maxVal=0, bestK=0, bestN=2
+    // Grow k*1 || k*2 || ... per lane until the next product would exceed
+    // 9 digits; returns the lanes holding a pandigital value with n >= 2
+    inline __mmask16 evaluate(__m512i kVec, __m512i& concatVec, __m512i& nVec) {
+        constexpr int MAX_N = 9;
+        const __m512i ten1    = _mm512_set1_epi32(10);
+        const __m512i ten2    = _mm512_set1_epi32(100);
+        const __m512i ten3    = _mm512_set1_epi32(1000);
+        const __m512i ten4    = _mm512_set1_epi32(10000);
+        const __m512i one     = _mm512_set1_epi32(1);
+        const __m512i nine    = _mm512_set1_epi32(9);
+        const __m512i full    = _mm512_set1_epi32(FULL_MASK);
 
-        for (int k = 1; k <= MAX_K; k += BATCH) {
-            int bs = std::min(BATCH, MAX_K - k + 1);
-            for (int i = 0; i < bs; ++i) kArr[i] = k + i;
-            for (int i = bs; i < BATCH; ++i) kArr[i] = 0;
+        // Running concatenation, digit count, digit mask and multiplier per lane
+        concatVec         = _mm512_setzero_si512();
+        nVec              = _mm512_setzero_si512();
+        __m512i digits    = _mm512_setzero_si512();
+        __m512i maskVec   = _mm512_setzero_si512();
+        __mmask16 dup     = 0;
 
-            __m512i kVec    = _mm512_load_epi32(kArr);
-            __m512i two     = _mm512_set1_epi32(2);
-            __m512i p1      = kVec;
-            __m512i p2      = _mm512_mullo_epi32(kVec, two);
+        for (int n = 1; n <= MAX_N; ++n) {
+            __m512i p = _mm512_mullo_epi32(kVec, _mm512_set1_epi32(n));
 
-            // Compute digit-shift for p2.
-            __m512i ten1    = _mm512_set1_epi32(10);
-            __m512i ten2    = _mm512_set1_epi32(100);
-            __m512i ten3    = _mm512_set1_epi32(1000);
-            __m512i ten4    = _mm512_set1_epi32(10000);
-
-            __mmask16 m1 = _mm512_cmp_epi32_mask(p2, ten1, _MM_CMPINT_LT);
-            __mmask16 m2 = _mm512_cmp_epi32_mask(p2, ten2, _MM_CMPINT_LT);
-            __mmask16 m3 = _mm512_cmp_epi32_mask(p2, ten3, _MM_CMPINT_LT);
-            __mmask16 m4 = _mm512_cmp_epi32_mask(p2, ten4, _MM_CMPINT_LT);
+            // Compute digit-shift and digit count for p.
+            __mmask16 m1 = _mm512_cmp_epi32_mask(p, ten1, _MM_CMPINT_LT);
+            __mmask16 m2 = _mm512_cmp_epi32_mask(p, ten2, _MM_CMPINT_LT);
+            __mmask16 m3 = _mm512_cmp_epi32_mask(p, ten3, _MM_CMPINT_LT);
+            __mmask16 m4 = _mm512_cmp_epi32_mask(p, ten4, _MM_CMPINT_LT);
 
             __m512i shift = _mm512_set1_epi32(100000);
             shift = _mm512_mask_blend_epi32(m4, shift, _mm512_set1_epi32(10000));
@@ -75,20 +94,127 @@ namespace impl::avx512 {
             shift = _mm512_mask_blend_epi32(m2, shift, _mm512_set1_epi32(100));
             shift = _mm512_mask_blend_epi32(m1, shift, _mm512_set1_epi32(10));
 
-            __m512i concatVec = _mm512_add_epi32(_mm512_mullo_epi32(p1, shift), p2);
-            _mm512_store_epi32(concatArr, concatVec);
-
-            for (int i = 0; i < bs; ++i) {
-                int val = concatArr[i];
-                int p1s = kArr[i];
-                int p2s = kArr[i] * 2;
-                if (maskPandigitalScalar(val, p1s, p2s) && val > result.maxVal) {
-                    result.maxVal = val;
-                    result.bestK = p1s;
-                }
+            __m512i pDigits = _mm512_set1_epi32(5);
+            pDigits = _mm512_mask_sub_epi32(pDigits, m4, pDigits, one);
+            pDigits = _mm512_mask_sub_epi32(pDigits, m3, pDigits, one);
+            pDigits = _mm512_mask_sub_epi32(pDigits, m2, pDigits, one);
+            pDigits = _mm512_mask_sub_epi32(pDigits, m1, pDigits, one);
+
+            // Lanes stop growing once another product would exceed 9 digits
+            __m512i newDigits = _mm512_add_epi32(digits, pDigits);
+            __mmask16 fits = _mm512_cmp_epi32_mask(newDigits, ten1, _MM_CMPINT_LT);
+
+            concatVec = _mm512_mask_add_epi32(concatVec, fits,
+                _mm512_mullo_epi32(concatVec, shift), p);
+            digits = _mm512_mask_mov_epi32(digits, fits, newDigits);
+            nVec = _mm512_mask_mov_epi32(nVec, fits, _mm512_set1_epi32(n));
+            accumulateDigits(p, fits, maskVec, dup);
+        }
+
+        // Valid lanes: 9 digits, every digit 1-9 present, no repeats, n >= 2
+        return _mm512_cmpeq_epi32_mask(digits, nine)
+             & _mm512_cmpeq_epi32_mask(maskVec, full)
+             & _mm512_cmp_epi32_mask(nVec, one, _MM_CMPINT_GT)
+             & static_cast<__mmask16>(~dup);
+    }
+
+    // Search k in [kBegin, kEnd]; k above MAX_K cannot give 9 digits with n >= 2.
+    // UNROLL independent batches per step hide the multiply latency; the best
+    // lanes stay in registers until the end of the range.
+    template <int UNROLL>
+    CalcResult calcUnrolled(int kBegin, int kEnd) {
+        constexpr int BATCH = 16;                // AVX-512 16 lanes
+        const __m512i step = _mm512_set1_epi32(UNROLL * BATCH);
+
+        CalcResult result = {0, 0, 0};
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        if (kEnd < kBegin) return result;
+
+        simd::Best16 best[UNROLL];
+        __m512i kVec[UNROLL];
+        for (int u = 0; u < UNROLL; ++u) kVec[u] = simd::kLanes16(kBegin + u * BATCH);
+        for (int k = kBegin; k <= kEnd; k += UNROLL * BATCH) {
+            for (int u = 0; u < UNROLL; ++u) {
+                __m512i concat, n;
+                __mmask16 valid = evaluate(kVec[u], concat, n) & simd::inRange16(kVec[u], kEnd);
+                simd::update(best[u], valid, concat, kVec[u], n);
+                kVec[u] = _mm512_add_epi32(kVec[u], step);
             }
         }
 
+        for (const auto& b : best) simd::reduce(b, result);
         return result;
     }
+
+    // Two batches per step unless a tuning profile says otherwise
+    CalcResult calc(int kBegin, int kEnd) {
+        return calcUnrolled<2>(kBegin, kEnd);
+    }
+
+    // Same search with unroll (1, 2 or 4) batches per step
+    CalcResult calc(int kBegin, int kEnd, int unroll) {
+        switch (unroll) {
+            case 1: return calcUnrolled<1>(kBegin, kEnd);
+            case 4: return calcUnrolled<4>(kBegin, kEnd);
+            default: return calcUnrolled<2>(kBegin, kEnd);
+        }
+    }
+
+    // Append every hit in [kBegin, kEnd] to out; valid lanes are
+    // compress-stored straight into the buffer columns
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        constexpr int BATCH = 16;
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m512i kVec = simd::kLanes16(k);
+            __m512i concatVec, nVec;
+            __mmask16 valid = evaluate(kVec, concatVec, nVec) & simd::inRange16(kVec, kEnd);
+
+            if (valid) {
+                out.reserve(BATCH);
+                _mm512_mask_compressstoreu_epi32(out.values(), valid, concatVec);
+                _mm512_mask_compressstoreu_epi32(out.ks(), valid, kVec);
+                _mm512_mask_compressstoreu_epi32(out.ns(), valid, nVec);
+                out.commit(hits::laneCount(valid));
+            }
+        }
+    }
+
+    // Keep the best heap.capacity() hits in [kBegin, kEnd]; lanes must
+    // reach the heap threshold in-register before they are offered
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        constexpr int BATCH = 16;
+        int valOut[BATCH], kOut[BATCH], nOut[BATCH];
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m512i kVec = simd::kLanes16(k);
+            __m512i concatVec, nVec;
+            __mmask16 valid = evaluate(kVec, concatVec, nVec) & simd::inRange16(kVec, kEnd);
+            valid &= _mm512_cmp_epi32_mask(concatVec, _mm512_set1_epi32(heap.threshold()), _MM_CMPINT_GE);
+
+            if (valid) {
+                _mm512_mask_compressstoreu_epi32(valOut, valid, concatVec);
+                _mm512_mask_compressstoreu_epi32(kOut, valid, kVec);
+                _mm512_mask_compressstoreu_epi32(nOut, valid, nVec);
+                size_t count = hits::laneCount(valid);
+                for (size_t i = 0; i < count; ++i) heap.offer({valOut[i], kOut[i], nOut[i]});
+            }
+        }
+    }
+
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
 }
\ No newline at end of file
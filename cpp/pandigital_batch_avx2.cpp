@@ -0,0 +1,191 @@
+/**
+ * @file pandigital_batch_avx2.cpp
+ * @brief AVX2 batch validation and classification
+ *
+ * 8 values per step in 32-bit lanes; the last count % 8 values go through
+ * the scalar kernel. Digit masks are built as in
+ * pandigital_avx2_advanced.cpp (reciprocal-multiply digit extraction,
+ * _mm256_sllv_epi32 digit bits, all-ones lane masks for live digits).
+ *
+ * Requirements:
+ * - CPU with AVX2 support
+ */
+#include <immintrin.h>
+#include "batch.h"
+#include "simd_divide.h"
+
+namespace impl::batch::avx2 {
+    namespace {
+        constexpr int LANES = 8;
+        constexpr int MAX_DIGITS = 10;   ///< Digits of a 32-bit value
+
+        inline __m256i nonZero(__m256i v) {
+            return _mm256_xor_si256(_mm256_cmpeq_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+        }
+
+        // Lanes (all ones) where hi * 100000 + lo (lo < 100000) is
+        // pandigital. All five digits of lo count once hi > 0; HiDigits
+        // bounds the digits of hi.
+        template <bool Zero, int HiDigits>
+        inline __m256i pandigitalLanes(__m256i hi, __m256i lo) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i hasHi = nonZero(hi);
+            __m256i mask = _mm256_setzero_si256();
+            __m256i digits = _mm256_setzero_si256();
+
+            __m256i v = lo;
+            for (int i = 0; i < 5; ++i) {
+                __m256i live = _mm256_or_si256(hasHi, nonZero(v));
+                __m256i q = simd::div10_epu32(v);
+                __m256i bit = _mm256_sllv_epi32(one, simd::rem_epu32<10>(v, q));
+                mask = _mm256_or_si256(mask, _mm256_and_si256(bit, live));
+                digits = _mm256_sub_epi32(digits, live);
+                v = q;
+            }
+            v = hi;
+            for (int i = 0; i < HiDigits; ++i) {
+                __m256i live = nonZero(v);
+                __m256i q = simd::div10_epu32(v);
+                __m256i bit = _mm256_sllv_epi32(one, simd::rem_epu32<10>(v, q));
+                mask = _mm256_or_si256(mask, _mm256_and_si256(bit, live));
+                digits = _mm256_sub_epi32(digits, live);
+                v = q;
+            }
+
+            // As many digits as mask bits, so a full mask rules out repeats
+            return _mm256_and_si256(
+                _mm256_cmpeq_epi32(digits, _mm256_set1_epi32(Zero ? 10 : 9)),
+                _mm256_cmpeq_epi32(mask, _mm256_set1_epi32(static_cast<int>(Zero ? MASK_0_9 : MASK_1_9))));
+        }
+
+        // Writes the 8 lane flags (0 or 1) of valid as bytes
+        inline void storeFlags(uint8_t* out, __m256i valid) {
+            const __m256i lowBytes = _mm256_setr_epi8(
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            __m256i bytes = _mm256_shuffle_epi8(_mm256_and_si256(valid, _mm256_set1_epi32(1)), lowBytes);
+            bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+        }
+
+        template <bool Zero>
+        size_t validate32(const uint32_t* values, size_t count, uint8_t* out) {
+            const __m256i split = _mm256_set1_epi32(100000);
+            size_t i = 0;
+            for (; i + LANES <= count; i += LANES) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+                __m256i hi = simd::div_epu32<3125, 27>(_mm256_srli_epi32(v, 5));   // v / 100000
+                __m256i lo = _mm256_sub_epi32(v, _mm256_mullo_epi32(hi, split));
+                storeFlags(out + i, pandigitalLanes<Zero, 5>(hi, lo));
+            }
+            return i;
+        }
+
+        // Low dwords of two 4 x 64-bit vectors as one 8 x 32-bit vector
+        inline __m256i narrow(__m256i a, __m256i b) {
+            const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            return _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(a, even))),
+                _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(b, even)), 1);
+        }
+
+        template <bool Zero>
+        size_t validate64(const uint64_t* values, size_t count, uint8_t* out) {
+            const __m256i split = _mm256_set1_epi32(100000);
+            const __m256i zero = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + LANES <= count; i += LANES) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 4));
+                // v < 2^34 (MAX_SPLIT); the 64-bit lane masks narrow like the values
+                __m256i fits = narrow(_mm256_cmpeq_epi64(_mm256_srli_epi64(a, 34), zero),
+                                      _mm256_cmpeq_epi64(_mm256_srli_epi64(b, 34), zero));
+
+                // v / 100000 == (v >> 5) / 3125, and v >> 5 < 2^29 for fitting lanes
+                __m256i hi = simd::div_epu32<3125, 29>(narrow(_mm256_srli_epi64(a, 5), _mm256_srli_epi64(b, 5)));
+                __m256i lo = _mm256_sub_epi32(narrow(a, b), _mm256_mullo_epi32(hi, split));
+                storeFlags(out + i, _mm256_and_si256(pandigitalLanes<Zero, 6>(hi, lo), fits));
+            }
+            return i;
+        }
+    }
+
+    void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero) {
+        size_t done = zero ? validate32<true>(values, count, out) : validate32<false>(values, count, out);
+        scalar::validate(values + done, count - done, out + done, zero);
+    }
+
+    void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero) {
+        size_t done = zero ? validate64<true>(values, count, out) : validate64<false>(values, count, out);
+        scalar::validate(values + done, count - done, out + done, zero);
+    }
+
+    void classify(const uint32_t* values, size_t count, pandigital::Product* out) {
+        alignas(32) int prefix[MAX_DIGITS][LANES];   // prefix[j][lane] = v / 10^j
+        alignas(32) static const int POW10[LANES] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i pow10 = _mm256_load_si256(reinterpret_cast<const __m256i*>(POW10));
+
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+
+            __m256i total = zero;
+            for (int j = 0; j < MAX_DIGITS; ++j) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(prefix[j]), q);
+                total = _mm256_sub_epi32(total, nonZero(q));
+                q = simd::div10_epu32(q);
+            }
+
+            __m256i kOut = zero;
+            __m256i nOut = zero;
+            __m256i found = zero;
+            for (int len = 1; 2 * len <= MAX_DIGITS; ++len) {
+                // k is the first len digits: prefix[total - len]
+                __m256i alive = _mm256_andnot_si256(found,
+                    _mm256_cmpgt_epi32(_mm256_add_epi32(total, one), _mm256_set1_epi32(2 * len)));
+                if (_mm256_testz_si256(alive, alive)) continue;
+                __m256i t = _mm256_set1_epi32(len);
+                __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(total, t), 3), lanes);
+                __m256i k = _mm256_mask_i32gather_epi32(zero, &prefix[0][0], index, alive, 4);
+                __m256i head = k;
+
+                for (int n = 2; n <= 9 && !_mm256_testz_si256(alive, alive); ++n) {
+                    // k < 10^5, so p < 10^6 compares correctly as signed
+                    __m256i p = _mm256_mullo_epi32(k, _mm256_set1_epi32(n));
+                    __m256i d = one;
+                    for (int e = 1; e <= 5; ++e) {
+                        d = _mm256_sub_epi32(d, _mm256_cmpgt_epi32(p, _mm256_set1_epi32(POW10[e] - 1)));
+                    }
+
+                    // The next d digits of the value must be exactly k*n
+                    t = _mm256_add_epi32(t, d);
+                    alive = _mm256_andnot_si256(_mm256_cmpgt_epi32(t, total), alive);
+                    index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(total, t), 3), lanes);
+                    __m256i next = _mm256_mask_i32gather_epi32(zero, &prefix[0][0], index, alive, 4);
+                    __m256i segment = _mm256_sub_epi32(next,
+                        _mm256_mullo_epi32(head, _mm256_permutevar8x32_epi32(pow10, d)));
+                    alive = _mm256_and_si256(alive, _mm256_cmpeq_epi32(segment, p));
+                    head = next;
+
+                    __m256i done = _mm256_and_si256(alive, _mm256_cmpeq_epi32(t, total));
+                    kOut = _mm256_blendv_epi8(kOut, k, done);
+                    nOut = _mm256_blendv_epi8(nOut, _mm256_set1_epi32(n), done);
+                    found = _mm256_or_si256(found, done);
+                    alive = _mm256_andnot_si256(done, alive);
+                }
+            }
+
+            // (k0 n0 k1 n1 | k4 n4 k5 n5) and (k2 n2 k3 n3 | k6 n6 k7 n7)
+            __m256i lo = _mm256_unpacklo_epi32(kOut, nOut);
+            __m256i hi = _mm256_unpackhi_epi32(kOut, nOut);
+            auto* dst = reinterpret_cast<__m256i*>(out + i);
+            _mm256_storeu_si256(dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        scalar::classify(values + i, count - i, out + i);
+    }
+}
@@ -0,0 +1,184 @@
+/**
+ * @file pandigital_batch_avx512.cpp
+ * @brief AVX-512 batch validation and classification
+ *
+ * 16 values per step in 32-bit lanes. Tails use masked loads and stores,
+ * so there is no scalar remainder loop. Digit masks are built as in
+ * pandigital_avx512.cpp (reciprocal-multiply digit extraction,
+ * _mm512_sllv_epi32 digit bits, lane masks for live digits).
+ *
+ * Requirements:
+ * - CPU with AVX-512F/BW/DQ/VL support
+ */
+#include <immintrin.h>
+#include "batch.h"
+#include "simd_divide.h"
+
+namespace impl::batch::avx512 {
+    namespace {
+        constexpr int LANES = 16;
+        constexpr int MAX_DIGITS = 10;   ///< Digits of a 32-bit value
+
+        inline __mmask16 tailMask(size_t remaining) {
+            return remaining >= LANES ? 0xFFFF : static_cast<__mmask16>((1u << remaining) - 1);
+        }
+
+        // Lanes where hi * 100000 + lo (lo < 100000) is pandigital. All five
+        // digits of lo count once hi > 0; HiDigits bounds the digits of hi.
+        template <bool Zero, int HiDigits>
+        inline __mmask16 pandigitalLanes(__m512i hi, __m512i lo) {
+            const __m512i one = _mm512_set1_epi32(1);
+            const __mmask16 hasHi = _mm512_test_epi32_mask(hi, hi);
+            __m512i mask = _mm512_setzero_si512();
+            __m512i digits = _mm512_setzero_si512();
+
+            __m512i v = lo;
+            for (int i = 0; i < 5; ++i) {
+                __mmask16 live = hasHi | _mm512_test_epi32_mask(v, v);
+                __m512i q = simd::div10_epu32(v);
+                __m512i bit = _mm512_sllv_epi32(one, simd::rem_epu32<10>(v, q));
+                mask = _mm512_mask_or_epi32(mask, live, mask, bit);
+                digits = _mm512_mask_add_epi32(digits, live, digits, one);
+                v = q;
+            }
+            v = hi;
+            for (int i = 0; i < HiDigits; ++i) {
+                __mmask16 live = _mm512_test_epi32_mask(v, v);
+                __m512i q = simd::div10_epu32(v);
+                __m512i bit = _mm512_sllv_epi32(one, simd::rem_epu32<10>(v, q));
+                mask = _mm512_mask_or_epi32(mask, live, mask, bit);
+                digits = _mm512_mask_add_epi32(digits, live, digits, one);
+                v = q;
+            }
+
+            // As many digits as mask bits, so a full mask rules out repeats
+            return _mm512_cmpeq_epi32_mask(digits, _mm512_set1_epi32(Zero ? 10 : 9))
+                 & _mm512_cmpeq_epi32_mask(mask, _mm512_set1_epi32(static_cast<int>(Zero ? MASK_0_9 : MASK_1_9)));
+        }
+
+        template <bool Zero>
+        void validate32(const uint32_t* values, size_t count, uint8_t* out) {
+            const __m512i split = _mm512_set1_epi32(100000);
+            for (size_t i = 0; i < count; i += LANES) {
+                const __mmask16 tail = tailMask(count - i);
+                __m512i v = _mm512_maskz_loadu_epi32(tail, values + i);
+                __m512i hi = simd::div_epu32<3125, 27>(_mm512_srli_epi32(v, 5));   // v / 100000
+                __m512i lo = _mm512_sub_epi32(v, _mm512_mullo_epi32(hi, split));
+                __mmask16 valid = pandigitalLanes<Zero, 5>(hi, lo);
+                _mm_mask_storeu_epi8(out + i, tail, _mm_maskz_set1_epi8(valid, 1));
+            }
+        }
+
+        // Low dwords of two 8 x 64-bit vectors as one 16 x 32-bit vector
+        inline __m512i narrow(__m512i a, __m512i b) {
+            return _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi64_epi32(a)),
+                                      _mm512_cvtepi64_epi32(b), 1);
+        }
+
+        template <bool Zero>
+        void validate64(const uint64_t* values, size_t count, uint8_t* out) {
+            const __m512i split = _mm512_set1_epi32(100000);
+            const __m512i limit = _mm512_set1_epi64(static_cast<long long>(MAX_SPLIT));
+            for (size_t i = 0; i < count; i += LANES) {
+                const __mmask16 tail = tailMask(count - i);
+                __m512i a = _mm512_maskz_loadu_epi64(static_cast<__mmask8>(tail), values + i);
+                __m512i b = _mm512_maskz_loadu_epi64(static_cast<__mmask8>(tail >> 8), values + i + 8);
+                __mmask16 fits = static_cast<__mmask16>(_mm512_cmplt_epu64_mask(a, limit)
+                               | (_mm512_cmplt_epu64_mask(b, limit) << 8));
+
+                // v / 100000 == (v >> 5) / 3125, and v >> 5 < 2^29 for fitting lanes
+                __m512i hi = simd::div_epu32<3125, 29>(narrow(_mm512_srli_epi64(a, 5), _mm512_srli_epi64(b, 5)));
+                __m512i lo = _mm512_sub_epi32(narrow(a, b), _mm512_mullo_epi32(hi, split));
+                __mmask16 valid = pandigitalLanes<Zero, 6>(hi, lo) & fits;
+                _mm_mask_storeu_epi8(out + i, tail, _mm_maskz_set1_epi8(valid, 1));
+            }
+        }
+    }
+
+    void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero) {
+        if (zero) {
+            validate32<true>(values, count, out);
+        } else {
+            validate32<false>(values, count, out);
+        }
+    }
+
+    void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero) {
+        if (zero) {
+            validate64<true>(values, count, out);
+        } else {
+            validate64<false>(values, count, out);
+        }
+    }
+
+    void classify(const uint32_t* values, size_t count, pandigital::Product* out) {
+        alignas(64) uint32_t prefix[MAX_DIGITS][LANES];   // prefix[j][lane] = v / 10^j
+        alignas(64) static const uint32_t POW10[LANES] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512i pow10 = _mm512_load_si512(POW10);
+        // Interleave k and n into Product pairs
+        const __m512i pairsLo = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+        const __m512i pairsHi = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+
+        for (size_t i = 0; i < count; i += LANES) {
+            const __mmask16 tail = tailMask(count - i);
+            __m512i q = _mm512_maskz_loadu_epi32(tail, values + i);
+
+            __m512i total = zero;
+            for (int j = 0; j < MAX_DIGITS; ++j) {
+                _mm512_store_si512(prefix[j], q);
+                total = _mm512_mask_add_epi32(total, _mm512_test_epi32_mask(q, q), total, one);
+                q = simd::div10_epu32(q);
+            }
+
+            __m512i kOut = zero;
+            __m512i nOut = zero;
+            __mmask16 found = 0;
+            for (int len = 1; 2 * len <= MAX_DIGITS; ++len) {
+                // k is the first len digits: prefix[total - len]
+                __mmask16 alive = _mm512_cmp_epi32_mask(_mm512_set1_epi32(2 * len), total, _MM_CMPINT_LE)
+                                & static_cast<__mmask16>(~found);
+                if (!alive) continue;
+                __m512i t = _mm512_set1_epi32(len);
+                __m512i index = _mm512_add_epi32(_mm512_slli_epi32(_mm512_sub_epi32(total, t), 4), lanes);
+                __m512i k = _mm512_mask_i32gather_epi32(zero, alive, index, prefix, 4);
+                __m512i head = k;
+
+                for (int n = 2; n <= 9 && alive; ++n) {
+                    __m512i p = _mm512_mullo_epi32(k, _mm512_set1_epi32(n));
+                    __m512i d = one;
+                    for (int e = 1; e <= 5; ++e) {
+                        __mmask16 ge = _mm512_cmp_epu32_mask(p, _mm512_set1_epi32(static_cast<int>(POW10[e])),
+                                                             _MM_CMPINT_NLT);
+                        d = _mm512_mask_add_epi32(d, ge, d, one);
+                    }
+
+                    // The next d digits of the value must be exactly k*n
+                    t = _mm512_add_epi32(t, d);
+                    alive &= _mm512_cmp_epi32_mask(t, total, _MM_CMPINT_LE);
+                    index = _mm512_add_epi32(_mm512_slli_epi32(_mm512_sub_epi32(total, t), 4), lanes);
+                    __m512i next = _mm512_mask_i32gather_epi32(zero, alive, index, prefix, 4);
+                    __m512i segment = _mm512_sub_epi32(next, _mm512_mullo_epi32(head, _mm512_permutexvar_epi32(d, pow10)));
+                    alive &= _mm512_cmpeq_epi32_mask(segment, p);
+                    head = next;
+
+                    __mmask16 done = alive & _mm512_cmpeq_epi32_mask(t, total);
+                    kOut = _mm512_mask_mov_epi32(kOut, done, k);
+                    nOut = _mm512_mask_mov_epi32(nOut, done, _mm512_set1_epi32(n));
+                    found |= done;
+                    alive &= static_cast<__mmask16>(~done);
+                }
+            }
+
+            auto* dst = reinterpret_cast<long long*>(out + i);
+            _mm512_mask_storeu_epi64(dst, static_cast<__mmask8>(tail),
+                                     _mm512_permutex2var_epi32(kOut, pairsLo, nOut));
+            _mm512_mask_storeu_epi64(dst + 8, static_cast<__mmask8>(tail >> 8),
+                                     _mm512_permutex2var_epi32(kOut, pairsHi, nOut));
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file pandigital_batch_scalar.cpp
+ * @brief Portable batch validation and classification
+ *
+ * Reference for the SIMD kernels and the fallback on CPUs without AVX2.
+ */
+#include "batch.h"
+
+namespace impl::batch::scalar {
+    namespace {
+        int digitsOf(uint64_t v) {
+            int d = 1;
+            for (; v >= 10; v /= 10) ++d;
+            return d;
+        }
+
+        uint32_t pow10(int e) {
+            uint32_t p = 1;
+            while (e-- > 0) p *= 10;
+            return p;
+        }
+
+        uint8_t check(uint64_t v, bool zero) {
+            uint32_t mask = 0;
+            int digits = 0;
+            for (; v != 0; v /= 10) {
+                mask |= 1u << (v % 10);
+                ++digits;
+            }
+            return zero ? (digits == 10 && mask == MASK_0_9) : (digits == 9 && mask == MASK_1_9);
+        }
+
+        pandigital::Product decompose(uint32_t v) {
+            if (v == 0) return {0, 0};
+            const int total = digitsOf(v);
+            for (int len = 1; 2 * len <= total; ++len) {
+                const uint32_t k = v / pow10(total - len);
+                int t = len;
+                for (uint32_t n = 2; t < total; ++n) {
+                    const uint32_t p = k * n;
+                    const int d = digitsOf(p);
+                    if (t + d > total) break;
+                    const uint32_t segment = (v / pow10(total - t - d)) % pow10(d);
+                    if (segment != p) break;
+                    t += d;
+                    if (t == total) return {k, n};
+                }
+            }
+            return {0, 0};
+        }
+    }
+
+    void validate(const uint32_t* values, size_t count, uint8_t* out, bool zero) {
+        for (size_t i = 0; i < count; ++i) out[i] = check(values[i], zero);
+    }
+
+    void validate(const uint64_t* values, size_t count, uint8_t* out, bool zero) {
+        for (size_t i = 0; i < count; ++i) out[i] = check(values[i], zero);
+    }
+
+    void classify(const uint32_t* values, size_t count, pandigital::Product* out) {
+        for (size_t i = 0; i < count; ++i) out[i] = decompose(values[i]);
+    }
+}
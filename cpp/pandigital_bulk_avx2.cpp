@@ -0,0 +1,84 @@
+/**
+ * @file pandigital_bulk_avx2.cpp
+ * @brief AVX2 line scanner for bulk validation
+ *
+ * Line ends come from one _mm256_cmpeq_epi8 + movemask per 32 bytes.
+ * A line of the right length is checked with the 16 bytes at its start:
+ * each required digit must occur in the first 9 (10) bytes, one
+ * _mm_cmpeq_epi8 per digit. As many bytes as digits means every byte is
+ * a distinct digit, so nothing is converted to an integer. The last
+ * bytes of the file, where a 32-byte load would leave the mapping, go
+ * through the scalar scanner.
+ *
+ * Requirements:
+ * - CPU with AVX2 support
+ */
+#include <immintrin.h>
+#include <cstring>
+#include "bulk.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace impl::bulk::avx2 {
+    namespace {
+        constexpr size_t BLOCK = 32;
+        constexpr size_t LINE_LOAD = 16;
+
+        inline unsigned lowestBit(uint32_t m) {
+#if defined(_MSC_VER)
+            unsigned long i;
+            _BitScanForward(&i, m);
+            return static_cast<unsigned>(i);
+#else
+            return static_cast<unsigned>(__builtin_ctz(m));
+#endif
+        }
+
+        // digits bytes at p form a pandigital; p + 16 must be readable
+        inline bool pandigitalLine(const char* p, int digits, bool zero) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const int lineMask = (1 << digits) - 1;
+            for (int d = zero ? 0 : 1; d <= 9; ++d) {
+                int seen = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>('0' + d))));
+                if (!(seen & lineMask)) return false;
+            }
+            return !zero || p[0] != '0';
+        }
+    }
+
+    uint64_t scanText(const char* data, size_t size, size_t begin, size_t end,
+                      bool zero, OffsetBuffer& out) {
+        const int digits = zero ? 10 : 9;
+        const __m256i newline = _mm256_set1_epi8('\n');
+        uint64_t lines = 0;
+
+        size_t start = begin;
+        for (size_t block = begin; start < end; block += BLOCK) {
+            if (block + BLOCK > size) {
+                return lines + scalar::scanText(data, size, start, end, zero, out);
+            }
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + block));
+            uint32_t ends = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)));
+            for (; ends != 0; ends &= ends - 1) {
+                size_t stop = block + lowestBit(ends);
+                size_t length = stop - start;
+                if (length > 0 && data[stop - 1] == '\r') --length;
+                if (length == static_cast<size_t>(digits)) {
+                    const char* line = data + start;
+                    char padded[LINE_LOAD] = {};
+                    if (start + LINE_LOAD > size) {
+                        std::memcpy(padded, line, length);   // 16-byte load would leave the mapping
+                        line = padded;
+                    }
+                    if (pandigitalLine(line, digits, zero)) out.push(start);
+                }
+                ++lines;
+                start = stop + 1;
+                if (start >= end) return lines;
+            }
+        }
+        return lines;
+    }
+}
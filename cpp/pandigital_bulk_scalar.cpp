@@ -0,0 +1,39 @@
+/**
+ * @file pandigital_bulk_scalar.cpp
+ * @brief Portable line scanner for bulk validation
+ *
+ * memchr for line ends and a digit bitmask per candidate line; also
+ * finishes the last bytes of the file for the AVX2 scanner.
+ */
+#include <cstring>
+#include "bulk.h"
+
+namespace impl::bulk::scalar {
+    namespace {
+        bool pandigitalLine(const char* p, size_t digits, bool zero) {
+            if (zero && p[0] == '0') return false;
+            unsigned mask = 0;
+            for (size_t i = 0; i < digits; ++i) {
+                unsigned d = static_cast<unsigned char>(p[i]) - '0';
+                if (d > 9) return false;
+                mask |= 1u << d;
+            }
+            return mask == (zero ? 0x3FFu : 0x3FEu);
+        }
+    }
+
+    uint64_t scanText(const char* data, size_t size, size_t begin, size_t end,
+                      bool zero, OffsetBuffer& out) {
+        const size_t digits = zero ? 10 : 9;
+        uint64_t lines = 0;
+        for (size_t start = begin; start < end && start < size; ++lines) {
+            const void* nl = std::memchr(data + start, '\n', size - start);
+            size_t stop = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) : size;
+            size_t length = stop - start;
+            if (length > 0 && data[stop - 1] == '\r') --length;
+            if (length == digits && pandigitalLine(data + start, digits, zero)) out.push(start);
+            start = stop + 1;
+        }
+        return lines;
+    }
+}
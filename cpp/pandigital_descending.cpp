@@ -0,0 +1,136 @@
+/**
+ * @file pandigital_descending.cpp
+ * @brief Inverse search: walks 1-9 pandigitals from the largest down
+ *
+ * Instead of scanning k upward and keeping a running maximum, this engine
+ * builds 9-digit pandigital permutations digit by digit in descending
+ * lexicographic order, which for equal-length numbers is descending
+ * numeric order. The first permutation that splits as k*1 || k*2 || ... ||
+ * k*n is therefore the answer and the search stops there.
+ *
+ * Pruning: every split length L = 1..4 of the leading k is tracked along
+ * the current prefix. Once L digits are placed, k is known and the rest of
+ * the number is forced to the digits of k*1 || k*2 || ...; a prefix is cut
+ * as soon as no split agrees with it. For the full range the answer is
+ * reached after about 2300 digit placements, with no per-k work at all.
+ *
+ * Memory usage: O(1), no allocation
+ */
+
+#include <algorithm>
+#include "calc_result.h"
+
+namespace impl::descending {
+    constexpr int MAX_K = 9999;
+
+    namespace {
+        constexpr int DIGITS = 9;
+        constexpr int MAX_K_DIGITS = 4;   ///< k*1 || k*2 needs 2 * digits(k) <= 9
+
+        /**
+         * @struct Split
+         * @brief Digits the permutation must have if it starts with k
+         */
+        struct Split {
+            int k;
+            int n;
+            int digits[DIGITS];
+        };
+
+        /**
+         * @brief Fills s with k*1 || k*2 || ... || k*n
+         * @return false if no n >= 2 makes the concatenation exactly 9 digits
+         */
+        bool expand(int k, Split& s) {
+            int length = 0;
+            for (int n = 1; length < DIGITS; ++n) {
+                int p = k * n;
+                int tmp[DIGITS];
+                int count = 0;
+                for (; p != 0; p /= 10) tmp[count++] = p % 10;
+                if (length + count > DIGITS) return false;
+                while (count > 0) s.digits[length++] = tmp[--count];
+                s.n = n;
+            }
+            s.k = k;
+            return s.n >= 2;
+        }
+
+        /**
+         * @struct Search
+         * @brief State of one descending walk
+         */
+        struct Search {
+            int kBegin;
+            int kEnd;
+            int prefix = 0;                   ///< Value of the digits placed so far
+            Split splits[MAX_K_DIGITS];       ///< splits[L - 1] is valid once L digits are placed
+            CalcResult result = {0, 0, 0};
+        };
+
+        /**
+         * @brief Places digit number depth + 1, largest candidates first
+         * @param used Bit d set if digit d is already placed
+         * @param alive Bit L - 1 set if split length L still agrees with the prefix
+         * @return true once a hit has been stored in s.result
+         */
+        bool descend(Search& s, int depth, unsigned used, unsigned alive) {
+            const int parent = s.prefix;
+            for (int digit = 9; digit >= 1; --digit) {
+                if (used & (1u << digit)) continue;
+
+                s.prefix = parent * 10 + digit;
+                unsigned next = 0;
+                for (int len = 1; len <= MAX_K_DIGITS; ++len) {
+                    const unsigned bit = 1u << (len - 1);
+                    if (!(alive & bit)) continue;
+                    if (len > depth + 1) {
+                        next |= bit;            // k not complete yet
+                    } else if (len == depth + 1) {
+                        if (s.prefix >= s.kBegin && s.prefix <= s.kEnd && expand(s.prefix, s.splits[len - 1])) {
+                            next |= bit;
+                        }
+                    } else if (s.splits[len - 1].digits[depth] == digit) {
+                        next |= bit;
+                    }
+                }
+                if (!next) continue;
+
+                if (depth + 1 == DIGITS) {
+                    // Shortest split first: the smallest k, as mergeMax would pick
+                    int shortest = 0;
+                    while (!(next & (1u << shortest))) ++shortest;
+                    const Split& hit = s.splits[shortest];
+                    s.result = {static_cast<uint64_t>(s.prefix), hit.k, hit.n};
+                    return true;
+                }
+                if (descend(s, depth + 1, used | (1u << digit), next)) return true;
+            }
+            s.prefix = parent;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Largest pandigital concatenated product with k in [kBegin, kEnd]
+     * @return Same result as simple::calc(kBegin, kEnd)
+     *
+     * Only splits whose k lies in the range are followed; the walk still
+     * stops at the first (largest) hit.
+     */
+    CalcResult calc(int kBegin, int kEnd) {
+        Search s;
+        s.kBegin = std::max(kBegin, 1);
+        s.kEnd = std::min(kEnd, MAX_K);
+        if (s.kBegin > s.kEnd) return s.result;
+        descend(s, 0, 0, (1u << MAX_K_DIGITS) - 1);
+        return s.result;
+    }
+
+    /**
+     * @brief Largest pandigital concatenated product over k = 1..MAX_K
+     */
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
+}
@@ -0,0 +1,187 @@
+/**
+ * @file pandigital_lut_avx2.cpp
+ * @brief Table-driven AVX2 implementation
+ *
+ * Validation of k*1 || ... || k*n is reduced to one gather per product:
+ * 1. Split p into hi = p / 10000 (one digit) and lo = p % 10000
+ * 2. Gather the packed mask/count/flag entry for lo from the digit table
+ * 3. OR in the bit of hi and fold into the running lane state
+ *
+ * Requirements:
+ * - AVX2 instruction set
+ *
+ * Performance characteristics:
+ * - Processes 8 numbers per SIMD operation
+ * - ~20 KB L1-resident table, no divide/modulo loops for digit masks
+ */
+#include <immintrin.h>
+#include <algorithm>
+#include "calc_result.h"
+#include "digit_table.h"
+#include "topk.h"
+#include "simd_best.h"
+#include "simd_divide.h"
+
+namespace impl::lut_avx2 {
+    constexpr int MAX_K = 9999;
+    constexpr int FULL_MASK = 0x3FE;
+
+    // Digit mask, digit count and bad flag (all-ones) of each lane of p < 100000
+    inline void lookup(__m256i p, const uint16_t* table,
+                       __m256i& mask, __m256i& count, __m256i& bad) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+
+        __m256i hi = simd::div10000_epu32(p);
+        __m256i lo = simd::rem_epu32<10000>(p, hi);
+
+        // Scale 2 reads entries lo and lo + 1; keep the low one
+        __m256i e = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), lo, 2);
+        __m256i loMask = _mm256_and_si256(e, _mm256_set1_epi32(digit_table::MASK_BITS));
+        __m256i loCount = _mm256_and_si256(_mm256_srli_epi32(e, digit_table::COUNT_SHIFT),
+                                           _mm256_set1_epi32(digit_table::COUNT_BITS));
+        __m256i loBad = _mm256_cmpgt_epi32(_mm256_and_si256(e, _mm256_set1_epi32(digit_table::BAD_FLAG)), zero);
+
+        // hi > 0: lo is printed with leading zeros and hi adds one digit
+        __m256i hasHi = _mm256_cmpgt_epi32(hi, zero);
+        __m256i hiBit = _mm256_sllv_epi32(one, hi);
+        __m256i padded = _mm256_cmpgt_epi32(_mm256_set1_epi32(1000), lo);
+        __m256i clash = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_and_si256(hiBit, loMask), zero),
+                                         _mm256_set1_epi32(-1));
+
+        mask = _mm256_blendv_epi8(loMask, _mm256_or_si256(loMask, hiBit), hasHi);
+        count = _mm256_blendv_epi8(loCount, _mm256_set1_epi32(5), hasHi);
+        bad = _mm256_or_si256(loBad, _mm256_and_si256(hasHi, _mm256_or_si256(padded, clash)));
+    }
+
+    // Grow k*1 || k*2 || ... per lane until the next product would exceed
+    // 9 digits; returns all-ones in lanes holding a pandigital value, n >= 2
+    inline __m256i evaluate(__m256i kVec, const uint16_t* table, __m256i& concat, __m256i& nVec) {
+        constexpr int MAX_N = 9;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ten = _mm256_set1_epi32(10);
+        const __m256i nine = _mm256_set1_epi32(9);
+        const __m256i full = _mm256_set1_epi32(FULL_MASK);
+        const __m256i pow10 = _mm256_setr_epi32(1, 10, 100, 1000, 10000, 100000, 1000000, 10000000);
+
+        concat = zero;
+        nVec = zero;
+        __m256i digits = zero;
+        __m256i maskVec = zero;
+        __m256i badVec = zero;
+
+        for (int n = 1; n <= MAX_N; ++n) {
+            __m256i p = _mm256_mullo_epi32(kVec, _mm256_set1_epi32(n));
+
+            __m256i pMask, pCount, pBad;
+            lookup(p, table, pMask, pCount, pBad);
+
+            // Lanes stop growing once another product would exceed 9 digits
+            __m256i newDigits = _mm256_add_epi32(digits, pCount);
+            __m256i fits = _mm256_cmpgt_epi32(ten, newDigits);
+
+            __m256i shift = _mm256_permutevar8x32_epi32(pow10, pCount);
+            __m256i newConcat = _mm256_add_epi32(_mm256_mullo_epi32(concat, shift), p);
+            __m256i repeat = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_and_si256(maskVec, pMask), zero),
+                                              _mm256_set1_epi32(-1));
+
+            concat = _mm256_blendv_epi8(concat, newConcat, fits);
+            digits = _mm256_blendv_epi8(digits, newDigits, fits);
+            maskVec = _mm256_blendv_epi8(maskVec, _mm256_or_si256(maskVec, pMask), fits);
+            badVec = _mm256_or_si256(badVec, _mm256_and_si256(fits, _mm256_or_si256(pBad, repeat)));
+            nVec = _mm256_blendv_epi8(nVec, _mm256_set1_epi32(n), fits);
+        }
+
+        __m256i valid = _mm256_and_si256(_mm256_cmpeq_epi32(digits, nine),
+                                         _mm256_cmpeq_epi32(maskVec, full));
+        valid = _mm256_andnot_si256(badVec, valid);
+        return _mm256_and_si256(valid, _mm256_cmpgt_epi32(nVec, _mm256_set1_epi32(1)));
+    }
+
+    // Search k in [kBegin, kEnd]; k above MAX_K cannot give 9 digits with n >= 2.
+    // UNROLL independent batches per step keep that many gather chains in flight;
+    // the best lanes stay in registers until the end of the range.
+    template <int UNROLL>
+    CalcResult calcUnrolled(int kBegin, int kEnd) {
+        constexpr int BATCH = 8;
+        const __m256i step = _mm256_set1_epi32(UNROLL * BATCH);
+
+        const uint16_t* table = digit_table::table();
+
+        CalcResult result = {0, 0, 0};
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        if (kEnd < kBegin) return result;
+
+        simd::Best8 best[UNROLL];
+        __m256i kVec[UNROLL];
+        for (int u = 0; u < UNROLL; ++u) kVec[u] = simd::kLanes8(kBegin + u * BATCH);
+        for (int k = kBegin; k <= kEnd; k += UNROLL * BATCH) {
+            for (int u = 0; u < UNROLL; ++u) {
+                __m256i concat, n;
+                __m256i valid = _mm256_and_si256(evaluate(kVec[u], table, concat, n), simd::inRange8(kVec[u], kEnd));
+                simd::update(best[u], valid, concat, kVec[u], n);
+                kVec[u] = _mm256_add_epi32(kVec[u], step);
+            }
+        }
+
+        for (const auto& b : best) simd::reduce(b, result);
+        return result;
+    }
+
+    // Two batches per step unless a tuning profile says otherwise
+    CalcResult calc(int kBegin, int kEnd) {
+        return calcUnrolled<2>(kBegin, kEnd);
+    }
+
+    // Same search with unroll (1, 2 or 4) batches per step
+    CalcResult calc(int kBegin, int kEnd, int unroll) {
+        switch (unroll) {
+            case 1: return calcUnrolled<1>(kBegin, kEnd);
+            case 4: return calcUnrolled<4>(kBegin, kEnd);
+            default: return calcUnrolled<2>(kBegin, kEnd);
+        }
+    }
+
+    // Keep the best heap.capacity() hits in [kBegin, kEnd]; lanes must
+    // reach the heap threshold in-register before they are offered
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        constexpr int BATCH = 8;
+        alignas(32) int kArr[BATCH];
+        alignas(32) int concatArr[BATCH];
+        alignas(32) int nArr[BATCH];
+
+        const uint16_t* table = digit_table::table();
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m256i kVec = simd::kLanes8(k);
+            __m256i concat, nVec;
+            __m256i valid = _mm256_and_si256(evaluate(kVec, table, concat, nVec), simd::inRange8(kVec, kEnd));
+            valid = _mm256_and_si256(valid,
+                _mm256_cmpgt_epi32(concat, _mm256_set1_epi32(heap.threshold() - 1)));
+
+            int laneMask = _mm256_movemask_ps(_mm256_castsi256_ps(valid));
+            if (laneMask) {
+                _mm256_store_si256(reinterpret_cast<__m256i *>(kArr), kVec);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(concatArr), concat);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(nArr), nVec);
+                for (int i = 0; i < BATCH; ++i) {
+                    if (laneMask & (1 << i)) heap.offer({concatArr[i], kArr[i], nArr[i]});
+                }
+            }
+        }
+    }
+
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
+}
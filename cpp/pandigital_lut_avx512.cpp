@@ -0,0 +1,174 @@
+/**
+ * @file pandigital_lut_avx512.cpp
+ * @brief Table-driven AVX-512 implementation
+ *
+ * Same scheme as pandigital_lut_avx2.cpp on 16 lanes: one
+ * _mm512_i32gather_epi32 into the digit table per product, mask
+ * registers for lane state and an in-register best-lane reduction.
+ * topK() filters lanes against the heap threshold before compress-storing.
+ *
+ * Requirements:
+ * - CPU with AVX-512F/BW/DQ/VL support
+ */
+#include <immintrin.h>
+#include <algorithm>
+#include "calc_result.h"
+#include "digit_table.h"
+#include "topk.h"
+#include "simd_best.h"
+#include "simd_divide.h"
+
+namespace impl::lut_avx512 {
+    constexpr int MAX_K = 9999;
+    constexpr int FULL_MASK = 0x3FE;
+
+    // Digit mask, digit count and bad lanes of p < 100000
+    inline void lookup(__m512i p, const uint16_t* table,
+                       __m512i& mask, __m512i& count, __mmask16& bad) {
+        const __m512i one = _mm512_set1_epi32(1);
+
+        __m512i hi = simd::div10000_epu32(p);
+        __m512i lo = simd::rem_epu32<10000>(p, hi);
+
+        // Scale 2 reads entries lo and lo + 1; keep the low one
+        __m512i e = _mm512_i32gather_epi32(lo, table, 2);
+        __m512i loMask = _mm512_and_si512(e, _mm512_set1_epi32(digit_table::MASK_BITS));
+        __m512i loCount = _mm512_and_si512(_mm512_srli_epi32(e, digit_table::COUNT_SHIFT),
+                                           _mm512_set1_epi32(digit_table::COUNT_BITS));
+        __mmask16 loBad = _mm512_test_epi32_mask(e, _mm512_set1_epi32(digit_table::BAD_FLAG));
+
+        // hi > 0: lo is printed with leading zeros and hi adds one digit
+        __mmask16 hasHi = _mm512_test_epi32_mask(hi, hi);
+        __m512i hiBit = _mm512_sllv_epi32(one, hi);
+        __mmask16 padded = _mm512_cmp_epu32_mask(lo, _mm512_set1_epi32(1000), _MM_CMPINT_LT);
+        __mmask16 clash = _mm512_test_epi32_mask(hiBit, loMask);
+
+        mask = _mm512_mask_or_epi32(loMask, hasHi, loMask, hiBit);
+        count = _mm512_mask_mov_epi32(loCount, hasHi, _mm512_set1_epi32(5));
+        bad = loBad | (hasHi & (padded | clash));
+    }
+
+    // Grow k*1 || k*2 || ... per lane until the next product would exceed
+    // 9 digits; returns the lanes holding a pandigital value with n >= 2
+    inline __mmask16 evaluate(__m512i kVec, const uint16_t* table, __m512i& concat, __m512i& nVec) {
+        constexpr int MAX_N = 9;
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i ten = _mm512_set1_epi32(10);
+        const __m512i nine = _mm512_set1_epi32(9);
+        const __m512i full = _mm512_set1_epi32(FULL_MASK);
+        const __m512i pow10 = _mm512_setr_epi32(1, 10, 100, 1000, 10000, 100000, 1000000, 10000000,
+                                                100000000, 1000000000, 0, 0, 0, 0, 0, 0);
+
+        concat = _mm512_setzero_si512();
+        nVec = _mm512_setzero_si512();
+        __m512i digits = _mm512_setzero_si512();
+        __m512i maskVec = _mm512_setzero_si512();
+        __mmask16 bad = 0;
+
+        for (int n = 1; n <= MAX_N; ++n) {
+            __m512i p = _mm512_mullo_epi32(kVec, _mm512_set1_epi32(n));
+
+            __m512i pMask, pCount;
+            __mmask16 pBad;
+            lookup(p, table, pMask, pCount, pBad);
+
+            // Lanes stop growing once another product would exceed 9 digits
+            __m512i newDigits = _mm512_add_epi32(digits, pCount);
+            __mmask16 fits = _mm512_cmp_epi32_mask(newDigits, ten, _MM_CMPINT_LT);
+
+            __m512i shift = _mm512_permutexvar_epi32(pCount, pow10);
+            concat = _mm512_mask_add_epi32(concat, fits, _mm512_mullo_epi32(concat, shift), p);
+            digits = _mm512_mask_mov_epi32(digits, fits, newDigits);
+            bad |= fits & (pBad | _mm512_test_epi32_mask(maskVec, pMask));
+            maskVec = _mm512_mask_or_epi32(maskVec, fits, maskVec, pMask);
+            nVec = _mm512_mask_mov_epi32(nVec, fits, _mm512_set1_epi32(n));
+        }
+
+        return _mm512_cmpeq_epi32_mask(digits, nine)
+             & _mm512_cmpeq_epi32_mask(maskVec, full)
+             & _mm512_cmp_epi32_mask(nVec, one, _MM_CMPINT_GT)
+             & static_cast<__mmask16>(~bad);
+    }
+
+    // Search k in [kBegin, kEnd]; k above MAX_K cannot give 9 digits with n >= 2.
+    // UNROLL independent batches per step hide the multiply latency; the best
+    // lanes stay in registers until the end of the range.
+    template <int UNROLL>
+    CalcResult calcUnrolled(int kBegin, int kEnd) {
+        constexpr int BATCH = 16;                // AVX-512 16 lanes
+        const __m512i step = _mm512_set1_epi32(UNROLL * BATCH);
+
+        const uint16_t* table = digit_table::table();
+
+        CalcResult result = {0, 0, 0};
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        if (kEnd < kBegin) return result;
+
+        simd::Best16 best[UNROLL];
+        __m512i kVec[UNROLL];
+        for (int u = 0; u < UNROLL; ++u) kVec[u] = simd::kLanes16(kBegin + u * BATCH);
+        for (int k = kBegin; k <= kEnd; k += UNROLL * BATCH) {
+            for (int u = 0; u < UNROLL; ++u) {
+                __m512i concat, n;
+                __mmask16 valid = evaluate(kVec[u], table, concat, n) & simd::inRange16(kVec[u], kEnd);
+                simd::update(best[u], valid, concat, kVec[u], n);
+                kVec[u] = _mm512_add_epi32(kVec[u], step);
+            }
+        }
+
+        for (const auto& b : best) simd::reduce(b, result);
+        return result;
+    }
+
+    // Two batches per step unless a tuning profile says otherwise
+    CalcResult calc(int kBegin, int kEnd) {
+        return calcUnrolled<2>(kBegin, kEnd);
+    }
+
+    // Same search with unroll (1, 2 or 4) batches per step
+    CalcResult calc(int kBegin, int kEnd, int unroll) {
+        switch (unroll) {
+            case 1: return calcUnrolled<1>(kBegin, kEnd);
+            case 4: return calcUnrolled<4>(kBegin, kEnd);
+            default: return calcUnrolled<2>(kBegin, kEnd);
+        }
+    }
+
+    // Keep the best heap.capacity() hits in [kBegin, kEnd]; lanes must
+    // reach the heap threshold in-register before they are offered
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        constexpr int BATCH = 16;
+        int valOut[BATCH], kOut[BATCH], nOut[BATCH];
+
+        const uint16_t* table = digit_table::table();
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += BATCH) {
+            __m512i kVec = simd::kLanes16(k);
+            __m512i concat, nVec;
+            __mmask16 valid = evaluate(kVec, table, concat, nVec) & simd::inRange16(kVec, kEnd);
+            valid &= _mm512_cmp_epi32_mask(concat, _mm512_set1_epi32(heap.threshold()), _MM_CMPINT_GE);
+
+            if (valid) {
+                _mm512_mask_compressstoreu_epi32(valOut, valid, concat);
+                _mm512_mask_compressstoreu_epi32(kOut, valid, kVec);
+                _mm512_mask_compressstoreu_epi32(nOut, valid, nVec);
+                size_t count = hits::laneCount(valid);
+                for (size_t i = 0; i < count; ++i) heap.offer({valOut[i], kOut[i], nOut[i]});
+            }
+        }
+    }
+
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
+}
@@ -0,0 +1,207 @@
+/**
+ * @file pandigital_parallel.cpp
+ * @brief Thread pool and chunked k-range driver
+ *
+ * Work distribution:
+ * 1. Chunks of `chunk` consecutive k values are claimed with an atomic counter
+ * 2. Each worker reduces into its own cache-line padded CalcResult
+ * 3. The caller merges the per-worker results with mergeMax
+ *
+ * Enumeration replaces step 2 with a per-worker HitBuffer whose full
+ * blocks are forwarded to the caller's sink under a mutex. Top-K runs
+ * one bounded heap per worker and merges the heaps.
+ *
+ * Dynamic claiming keeps all cores busy even though the cost per k varies
+ * between kernels (e.g. snprintf in base_simd vs. pure SIMD in avx512).
+ */
+#include <algorithm>
+#include <atomic>
+#include "parallel.h"
+
+namespace impl::parallel {
+    ThreadPool::ThreadPool(unsigned threads) {
+        threads = std::max(threads, 1u);
+        workers.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    void ThreadPool::run(const std::function<void(unsigned)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            pending = static_cast<unsigned>(workers.size());
+            ++generation;
+        }
+        wake.notify_all();
+
+        fn(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+    void ThreadPool::workerLoop(unsigned worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* fn;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+            }
+
+            (*fn)(worker);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+    namespace {
+        std::atomic<int> tunedChunk{DEFAULT_CHUNK};
+    }
+
+    int defaultChunk() {
+        return tunedChunk.load(std::memory_order_relaxed);
+    }
+
+    void setDefaultChunk(int chunk) {
+        tunedChunk.store(chunk > 0 ? chunk : DEFAULT_CHUNK, std::memory_order_relaxed);
+    }
+
+    ThreadPool& defaultPool() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    CalcResult calc(ThreadPool& pool, const RangeKernel& kernel,
+                    int kBegin, int kEnd, int chunk) {
+        // Padded so neighbouring workers never share a cache line
+        struct alignas(64) Partial {
+            CalcResult result = {0, 0, 0};
+        };
+
+        CalcResult best = {0, 0, 0};
+        if (kEnd < kBegin) return best;
+
+        chunk = chunk > 0 ? chunk : defaultChunk();
+        const int64_t span = static_cast<int64_t>(kEnd) - kBegin + 1;
+        const int64_t chunks = (span + chunk - 1) / chunk;
+
+        std::vector<Partial> partials(pool.size());
+        std::atomic<int64_t> next{0};
+
+        pool.run([&](unsigned worker) {
+            CalcResult& local = partials[worker].result;
+            for (int64_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+                 c = next.fetch_add(1, std::memory_order_relaxed)) {
+                int lo = static_cast<int>(kBegin + c * chunk);
+                int hi = static_cast<int>(std::min<int64_t>(kEnd, kBegin + (c + 1) * chunk - 1));
+                mergeMax(local, kernel(lo, hi));
+            }
+        });
+
+        for (const auto& p : partials) mergeMax(best, p.result);
+        return best;
+    }
+
+    CalcResult calc(const RangeKernel& kernel, int kBegin, int kEnd, int chunk) {
+        return calc(defaultPool(), kernel, kBegin, kEnd, chunk);
+    }
+
+    namespace {
+        // Runs kernel over [kBegin, kEnd] in claimed chunks; makeSink(worker)
+        // supplies the sink behind each worker's HitBuffer
+        template <typename MakeSink>
+        uint64_t forEachChunk(ThreadPool& pool, const EnumerateKernel& kernel,
+                              int kBegin, int kEnd, int chunk, MakeSink makeSink) {
+            if (kEnd < kBegin) return 0;
+
+            chunk = chunk > 0 ? chunk : defaultChunk();
+            const int64_t span = static_cast<int64_t>(kEnd) - kBegin + 1;
+            const int64_t chunks = (span + chunk - 1) / chunk;
+
+            std::atomic<int64_t> next{0};
+            std::atomic<uint64_t> total{0};
+
+            pool.run([&](unsigned worker) {
+                hits::HitBuffer buffer(makeSink(worker));
+                for (int64_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+                     c = next.fetch_add(1, std::memory_order_relaxed)) {
+                    int lo = static_cast<int>(kBegin + c * chunk);
+                    int hi = static_cast<int>(std::min<int64_t>(kEnd, kBegin + (c + 1) * chunk - 1));
+                    kernel(lo, hi, buffer);
+                }
+                buffer.flush();
+                total.fetch_add(buffer.appended(), std::memory_order_relaxed);
+            });
+            return total.load();
+        }
+    }
+
+    uint64_t enumerate(ThreadPool& pool, const EnumerateKernel& kernel,
+                       int kBegin, int kEnd, const hits::Sink& sink, int chunk) {
+        std::mutex sinkMutex;
+        return forEachChunk(pool, kernel, kBegin, kEnd, chunk, [&](unsigned) -> hits::Sink {
+            return [&](const hits::Hit* h, size_t count) {
+                std::lock_guard<std::mutex> lock(sinkMutex);
+                sink(h, count);
+            };
+        });
+    }
+
+    std::vector<hits::Hit> collect(ThreadPool& pool, const EnumerateKernel& kernel,
+                                   int kBegin, int kEnd, int chunk) {
+        std::vector<std::vector<hits::Hit>> perWorker(pool.size());
+        forEachChunk(pool, kernel, kBegin, kEnd, chunk, [&](unsigned worker) -> hits::Sink {
+            auto& out = perWorker[worker];
+            return [&out](const hits::Hit* h, size_t count) { out.insert(out.end(), h, h + count); };
+        });
+
+        std::vector<hits::Hit> all;
+        for (auto& part : perWorker) all.insert(all.end(), part.begin(), part.end());
+        std::sort(all.begin(), all.end(), hits::greater);
+        return all;
+    }
+
+    std::vector<hits::Hit> topK(ThreadPool& pool, const TopKKernel& kernel, size_t count,
+                                int kBegin, int kEnd, int chunk) {
+        // Built in place: copying a TopK would drop the reserved storage
+        std::vector<hits::TopK> heaps;
+        heaps.reserve(pool.size());
+        for (unsigned w = 0; w < pool.size(); ++w) heaps.emplace_back(count);
+        if (kEnd >= kBegin) {
+            chunk = chunk > 0 ? chunk : defaultChunk();
+            const int64_t span = static_cast<int64_t>(kEnd) - kBegin + 1;
+            const int64_t chunks = (span + chunk - 1) / chunk;
+            std::atomic<int64_t> next{0};
+
+            pool.run([&](unsigned worker) {
+                hits::TopK& local = heaps[worker];
+                for (int64_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+                     c = next.fetch_add(1, std::memory_order_relaxed)) {
+                    int lo = static_cast<int>(kBegin + c * chunk);
+                    int hi = static_cast<int>(std::min<int64_t>(kEnd, kBegin + (c + 1) * chunk - 1));
+                    kernel(lo, hi, local);
+                }
+            });
+        }
+
+        for (size_t w = 1; w < heaps.size(); ++w) heaps[0].merge(heaps[w]);
+        return heaps[0].sorted();
+    }
+}
@@ -0,0 +1,256 @@
+/**
+ * @file pandigital_portable.cpp
+ * @brief Portable scalar engine: no ISA flags, no heap, no libc calls
+ *
+ * The fallback for hosts without AVX2. Where the simple engine builds
+ * strings, this one works on integers with small constant tables:
+ * 1. Digit histograms from two digits at a time: a product p <= 89991 is
+ *    split into three pairs p / 10000, (p / 100) % 100 and p % 100, and
+ *    PAIR_HIST holds the 3-bit-per-digit histogram of each pair (with its
+ *    leading zero), so the histogram of p is three loads and two adds,
+ *    minus the zeros that only pad p to six digits.
+ * 2. Digit counts from the bit length: all numbers of one bit length have
+ *    one of two digit counts, DIGITS_OF_BITS gives the smaller, and one
+ *    compare against POW10 settles it. The bit length is a count-leading-
+ *    zeros builtin on GCC and Clang and five branch-free halving steps
+ *    elsewhere.
+ * 3. A branchless check: k values are processed in batches of LANES, and
+ *    every lane runs the same multipliers with bit selects instead of
+ *    early exits (as many as the smallest k of the batch needs), so the
+ *    lane loop has no branches and the compiler can vectorize it wherever
+ *    the target has gathers (AVX2, AVX-512, SVE; the lane loops carry
+ *    `#pragma omp simd`, enabled by -fopenmp-simd without the OpenMP
+ *    runtime); on baseline x86-64 it runs as straight-line scalar code.
+ *    A lane is a hit iff its concatenation has 9 digits and its
+ *    histogram holds each of 1..9 once and no 0. All lane state is
+ *    32-bit: the concatenation is exact whenever it has at most 9
+ *    digits, and a histogram field can only overflow on a count of 8,
+ *    which with 9 digits in total can never equal the pandigital
+ *    histogram (a carry drops its base-8 digit sum below 9).
+ *
+ * Memory usage: O(1), no allocation (calcTopK() returns a vector, as in
+ * every engine)
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+
+namespace impl::portable {
+    constexpr int MAX_K = 9999;
+
+    namespace {
+        constexpr int MAX_N = 9;
+        constexpr int LANES = 16;       ///< k values per batch
+        constexpr int DIGIT_BITS = 3;   ///< Histogram field width (base-8 digit per decimal digit)
+
+        /// Histogram with each of 1..9 once and no 0: octal 1111111110
+        constexpr uint32_t PANDIGITAL_HIST = 01111111110u;
+
+        constexpr uint32_t POW10[6] = {1, 10, 100, 1000, 10000, 100000};
+
+        struct PairTable {
+            uint32_t hist[100];
+        };
+
+        constexpr PairTable makePairTable() {
+            PairTable t{};
+            for (int i = 0; i < 100; ++i) {
+                t.hist[i] = (1u << (DIGIT_BITS * (i / 10))) + (1u << (DIGIT_BITS * (i % 10)));
+            }
+            return t;
+        }
+
+        /// Histogram of the two digits of 0..99, leading zero included
+        constexpr PairTable PAIR_HIST = makePairTable();
+
+        /// Digit count of 2^(b - 1), the smallest b-bit number (0 counts as one digit)
+        constexpr int DIGITS_OF_BITS[18] = {1, 1, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5};
+
+        /// Bit length of x < 2^32 (1 for 0, which digitCount also counts as one digit)
+        inline int bitLength(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+            return 32 - __builtin_clz(x | 1);
+#else
+            int length = 0;
+            int shift = static_cast<int>(x > 0xFFFF) << 4;
+            x >>= shift;
+            length += shift;
+            shift = static_cast<int>(x > 0xFF) << 3;
+            x >>= shift;
+            length += shift;
+            shift = static_cast<int>(x > 0xF) << 2;
+            x >>= shift;
+            length += shift;
+            shift = static_cast<int>(x > 0x3) << 1;
+            x >>= shift;
+            length += shift;
+            shift = static_cast<int>(x > 0x1);
+            x >>= shift;
+            length += shift;
+            return length + 1;
+#endif
+        }
+
+        /// Decimal digit count of p <= 89991
+        inline int digitCount(uint32_t p) {
+            const int guess = DIGITS_OF_BITS[bitLength(p)];
+            return guess + static_cast<int>(p >= POW10[guess]);
+        }
+
+        /// Histogram of the digits of p <= 89991 with digit count d
+        inline uint32_t histogram(uint32_t p, int d) {
+            const uint32_t padded = PAIR_HIST.hist[p / 10000] + PAIR_HIST.hist[(p / 100) % 100]
+                                  + PAIR_HIST.hist[p % 100];
+            return padded - static_cast<uint32_t>(6 - d);
+        }
+
+        /// Multipliers k needs to reach 9 or more digits (9 for k = 0)
+        inline int multipliers(uint32_t k) {
+            int digits = 0;
+            int n = 0;
+            while (digits < 9 && n < MAX_N) {
+                ++n;
+                digits += digitCount(k * static_cast<uint32_t>(n));
+            }
+            return n;
+        }
+
+        /**
+         * @struct Batch
+         * @brief Per-lane state of LANES consecutive k values
+         *
+         * value is the pandigital concatenation or 0; n is the multiplier
+         * that completed it.
+         */
+        struct Batch {
+            uint32_t value[LANES];
+            int n[LANES];
+        };
+
+        /**
+         * @brief Evaluates k = kStart .. kStart + LANES - 1
+         *
+         * Lanes past kEnd run with k = 0, which never has 9 digits without
+         * a 0.
+         */
+        void evaluate(int kStart, int kEnd, Batch& out) {
+            uint32_t k[LANES];
+            uint32_t concat[LANES];
+            uint32_t hist[LANES];
+            int digits[LANES];
+            int lastN[LANES];
+            for (int i = 0; i < LANES; ++i) {
+                k[i] = kStart + i <= kEnd ? static_cast<uint32_t>(kStart + i) : 0;
+                concat[i] = 0;
+                hist[i] = 0;
+                digits[i] = 0;
+                lastN[i] = 0;
+            }
+
+            // A lane takes k * n while it has fewer than 9 digits; the
+            // product that reaches 9 or more is the last one it takes.
+            // Every lane gets there no later than the smallest k
+            const int nLast = multipliers(static_cast<uint32_t>(kStart));
+            for (int n = 1; n <= nLast; ++n) {
+#pragma omp simd
+                for (int i = 0; i < LANES; ++i) {
+                    const uint32_t p = k[i] * static_cast<uint32_t>(n);
+                    const int d = digitCount(p);
+                    const uint32_t h = histogram(p, d);
+                    const uint32_t grown = concat[i] * POW10[d] + p;
+                    const int take = -static_cast<int>(digits[i] < 9);   // all ones or 0
+                    const uint32_t takeBits = static_cast<uint32_t>(take);
+                    concat[i] = (grown & takeBits) | (concat[i] & ~takeBits);
+                    hist[i] += h & takeBits;
+                    digits[i] += d & take;
+                    lastN[i] = (n & take) | (lastN[i] & ~take);
+                }
+            }
+
+#pragma omp simd
+            for (int i = 0; i < LANES; ++i) {
+                const bool hit = digits[i] == 9 && hist[i] == PANDIGITAL_HIST && lastN[i] >= 2;
+                out.value[i] = hit ? concat[i] : 0;
+                out.n[i] = lastN[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Calculates the largest pandigital concatenated product k*1 || k*2 || ... || k*n
+     * @param kBegin First k to test (inclusive)
+     * @param kEnd Last k to test (inclusive)
+     * @return CalcResult containing the maximum value and the k, n producing it
+     *
+     * Lanes are folded in k order with a strict compare, so ties keep the
+     * smallest k, as in simple::calc.
+     */
+    CalcResult calc(int kBegin, int kEnd) {
+        CalcResult result = {0, 0, 0};
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        Batch batch;
+        for (int k = kBegin; k <= kEnd; k += LANES) {
+            evaluate(k, kEnd, batch);
+            for (int i = 0; i < LANES; ++i) {
+                const bool better = batch.value[i] > result.maxVal;
+                result.maxVal = better ? batch.value[i] : result.maxVal;
+                result.bestK = better ? k + i : result.bestK;
+                result.bestN = better ? batch.n[i] : result.bestN;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Appends every pandigital concatenated product with k in [kBegin, kEnd] to out
+     */
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        Batch batch;
+        for (int k = kBegin; k <= kEnd; k += LANES) {
+            evaluate(k, kEnd, batch);
+            for (int i = 0; i < LANES; ++i) {
+                if (batch.value[i] != 0) out.push(static_cast<int>(batch.value[i]), k + i, batch.n[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Keeps the best heap.capacity() hits with k in [kBegin, kEnd]
+     */
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        Batch batch;
+        for (int k = kBegin; k <= kEnd; k += LANES) {
+            evaluate(k, kEnd, batch);
+            for (int i = 0; i < LANES; ++i) {
+                const int value = static_cast<int>(batch.value[i]);
+                if (value != 0 && value >= heap.threshold()) heap.offer({value, k + i, batch.n[i]});
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the count largest pandigital concatenated products, best first
+     */
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    /**
+     * @brief Calculates the largest pandigital concatenated product over k = 1..MAX_K
+     */
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
+}
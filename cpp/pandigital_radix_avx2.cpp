@@ -0,0 +1,173 @@
+/**
+ * @file pandigital_radix_avx2.cpp
+ * @brief AVX2 base-b implementation
+ *
+ * 8 k values per batch. Products, digit counts and digit masks use the
+ * 32-bit lanes of one ymm register; the concatenation is carried in two
+ * ymm registers of 4 x 64-bit lanes. AVX2 has no 64-bit multiply, so
+ * concat * Base^d is assembled from two _mm256_mul_epu32 partial products
+ * (the scale always fits 32 bits); power-of-two bases shift instead.
+ *
+ * Requirements:
+ * - CPU with AVX2 support
+ */
+#include <immintrin.h>
+#include <algorithm>
+#include "radix.h"
+#include "simd_best.h"
+#include "simd_divide.h"
+
+namespace impl::radix::avx2 {
+    namespace {
+        // Low and high 4 lanes of v widened to 64 bits (zero extension)
+        inline __m256i lowHalf(__m256i v) {
+            return _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v));
+        }
+
+        inline __m256i highHalf(__m256i v) {
+            return _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1));
+        }
+
+        // Sign extension turns an all-ones 32-bit lane mask into a 64-bit one
+        inline __m256i lowMask(__m256i m) {
+            return _mm256_cvtepi32_epi64(_mm256_castsi256_si128(m));
+        }
+
+        inline __m256i highMask(__m256i m) {
+            return _mm256_cvtepi32_epi64(_mm256_extracti128_si256(m, 1));
+        }
+
+        // a * b for 64-bit a and b < 2^32 (low dword of each 64-bit lane)
+        inline __m256i mul64x32(__m256i a, __m256i b) {
+            __m256i lo = _mm256_mul_epu32(a, b);
+            __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+            return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+
+        // Unsigned a >= b per 32-bit lane
+        inline __m256i cmpge_epu32(__m256i a, __m256i b) {
+            return _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a);
+        }
+
+        template <typename R>
+        inline __m256i divBase(__m256i v) {
+            if constexpr (R::POW2) {
+                return _mm256_srli_epi32(v, R::LOG2);
+            } else {
+                return simd::div_epu32<R::BASE, R::P_BITS>(v);
+            }
+        }
+
+        template <int Base, bool Zero>
+        CalcResult calcBase(int kBegin, int kEnd) {
+            using R = Radix<Base, Zero>;
+            constexpr int BATCH = 8;
+
+            // Base^1 .. Base^P_DIGITS, indexed by digit count - 1
+            static_assert(R::POW2 || R::P_DIGITS <= BATCH, "power table must fit one register");
+            alignas(32) uint32_t powArr[BATCH] = {};
+            for (int i = 0; i < R::P_DIGITS && !R::POW2; ++i) {
+                powArr[i] = static_cast<uint32_t>(ipow(Base, i + 1));
+            }
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i powTable = _mm256_load_si256(reinterpret_cast<const __m256i*>(powArr));
+            const __m256i base = _mm256_set1_epi32(Base);
+            const __m256i maxDigits = _mm256_set1_epi32(R::DIGITS);
+            const __m256i digitLimit = _mm256_set1_epi32(R::DIGITS + 1);
+
+            CalcResult result = {0, 0, 0};
+            simd::Best8x64 best;
+
+            kBegin = std::max(kBegin, 1);
+            kEnd = static_cast<int>(std::min<int64_t>(kEnd, int64_t{R::K_LIMIT} - 1));
+            __m256i kVec = simd::kLanes8(kBegin);
+            for (int k = kBegin; k <= kEnd; k += BATCH, kVec = _mm256_add_epi32(kVec, _mm256_set1_epi32(BATCH))) {
+                __m256i active = simd::inRange8(kVec, kEnd);
+
+                __m256i digits = zero;
+                __m256i maskVec = zero;
+                __m256i nVec = zero;
+                __m256i bad = zero;
+                __m256i concatLo = zero;
+                __m256i concatHi = zero;
+
+                for (int n = 1; n <= R::MAX_N; ++n) {
+                    __m256i p = _mm256_mullo_epi32(kVec, _mm256_set1_epi32(n));
+
+                    // Digit count: 1 + number of powers Base^i <= p (unsigned compares)
+                    __m256i pDigits = one;
+                    for (int i = 1; i < R::P_DIGITS; ++i) {
+                        __m256i ge = cmpge_epu32(p, _mm256_set1_epi32(static_cast<int>(ipow(Base, i))));
+                        pDigits = _mm256_sub_epi32(pDigits, ge);
+                    }
+
+                    // Lanes freeze for good once a product no longer fits
+                    __m256i newDigits = _mm256_add_epi32(digits, pDigits);
+                    active = _mm256_and_si256(active, _mm256_cmpgt_epi32(digitLimit, newDigits));
+                    if (_mm256_testz_si256(active, active)) break;
+
+                    __m256i v = p;
+                    for (int i = 0; i < R::P_DIGITS; ++i) {
+                        __m256i live = _mm256_andnot_si256(_mm256_cmpeq_epi32(v, zero), active);
+                        __m256i q = divBase<R>(v);
+                        __m256i digit = _mm256_sub_epi32(v, _mm256_mullo_epi32(q, base));
+                        __m256i bit = _mm256_and_si256(_mm256_sllv_epi32(one, digit), live);
+                        __m256i seen = _mm256_cmpeq_epi32(_mm256_and_si256(maskVec, bit), zero);
+                        bad = _mm256_or_si256(bad, _mm256_andnot_si256(seen, live));
+                        maskVec = _mm256_or_si256(maskVec, bit);
+                        v = q;
+                    }
+
+                    // concat = concat * Base^pDigits + p in 64-bit lanes
+                    __m256i shiftedLo, shiftedHi;
+                    if constexpr (R::POW2) {
+                        __m256i bits = _mm256_mullo_epi32(pDigits, _mm256_set1_epi32(R::LOG2));
+                        shiftedLo = _mm256_sllv_epi64(concatLo, lowHalf(bits));
+                        shiftedHi = _mm256_sllv_epi64(concatHi, highHalf(bits));
+                    } else {
+                        __m256i scale = _mm256_permutevar8x32_epi32(powTable, _mm256_sub_epi32(pDigits, one));
+                        shiftedLo = mul64x32(concatLo, lowHalf(scale));
+                        shiftedHi = mul64x32(concatHi, highHalf(scale));
+                    }
+                    concatLo = _mm256_blendv_epi8(concatLo, _mm256_add_epi64(shiftedLo, lowHalf(p)), lowMask(active));
+                    concatHi = _mm256_blendv_epi8(concatHi, _mm256_add_epi64(shiftedHi, highHalf(p)), highMask(active));
+                    digits = _mm256_blendv_epi8(digits, newDigits, active);
+                    nVec = _mm256_blendv_epi8(nVec, _mm256_set1_epi32(n), active);
+                }
+
+                // Digit 0 maps to bit 0 and is only allowed in zero mode
+                if constexpr (!R::ZERO) {
+                    bad = _mm256_or_si256(bad, _mm256_cmpeq_epi32(_mm256_and_si256(maskVec, one), one));
+                }
+                __m256i valid = _mm256_and_si256(_mm256_cmpeq_epi32(digits, maxDigits),
+                    _mm256_cmpeq_epi32(maskVec, _mm256_set1_epi32(static_cast<int>(R::FULL_MASK))));
+                valid = _mm256_and_si256(valid, _mm256_cmpgt_epi32(nVec, one));
+                valid = _mm256_andnot_si256(bad, valid);
+
+                simd::update(best, valid, concatLo, concatHi, kVec, nVec);
+            }
+            simd::reduce(best, result);
+            return result;
+        }
+
+        using Kernel = CalcResult (*)(int, int);
+
+        // [zero][base - MIN_BASE]; zero mode stops at MAX_ZERO_BASE
+        const Kernel KERNELS[2][MAX_BASE - MIN_BASE + 1] = {
+            {calcBase<2, false>, calcBase<3, false>, calcBase<4, false>, calcBase<5, false>,
+             calcBase<6, false>, calcBase<7, false>, calcBase<8, false>, calcBase<9, false>,
+             calcBase<10, false>, calcBase<11, false>, calcBase<12, false>, calcBase<13, false>,
+             calcBase<14, false>, calcBase<15, false>, calcBase<16, false>},
+            {calcBase<2, true>, calcBase<3, true>, calcBase<4, true>, calcBase<5, true>,
+             calcBase<6, true>, calcBase<7, true>, calcBase<8, true>, calcBase<9, true>,
+             calcBase<10, true>, calcBase<11, true>, calcBase<12, true>, calcBase<13, true>,
+             calcBase<14, true>, calcBase<15, true>, nullptr},
+        };
+    }
+
+    CalcResult calc(int base, int kBegin, int kEnd, bool zero) {
+        if (!supported(base, zero)) return {0, 0, 0};
+        return KERNELS[zero][base - MIN_BASE](kBegin, kEnd);
+    }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file pandigital_radix_avx512.cpp
+ * @brief AVX-512 base-b implementation
+ *
+ * 16 k values per batch. Products, digit counts and digit masks use the
+ * 32-bit lanes of one zmm register; the concatenation is carried in two
+ * zmm registers of 8 x 64-bit lanes and scaled with _mm512_mullo_epi64
+ * (AVX-512DQ), or with _mm512_sllv_epi64 when the base is a power of two.
+ *
+ * Requirements:
+ * - CPU with AVX-512F/BW/DQ/VL support
+ */
+#include <immintrin.h>
+#include <algorithm>
+#include "radix.h"
+#include "simd_best.h"
+#include "simd_divide.h"
+
+namespace impl::radix::avx512 {
+    namespace {
+        // Low and high 8 lanes of v widened to 64 bits
+        inline __m512i lowHalf(__m512i v) {
+            return _mm512_cvtepu32_epi64(_mm512_castsi512_si256(v));
+        }
+
+        inline __m512i highHalf(__m512i v) {
+            return _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(v, 1));
+        }
+
+        template <typename R>
+        inline __m512i divBase(__m512i v) {
+            if constexpr (R::POW2) {
+                return _mm512_srli_epi32(v, R::LOG2);
+            } else {
+                return simd::div_epu32<R::BASE, R::P_BITS>(v);
+            }
+        }
+
+        template <int Base, bool Zero>
+        CalcResult calcBase(int kBegin, int kEnd) {
+            using R = Radix<Base, Zero>;
+            constexpr int BATCH = 16;
+
+            // Base^1 .. Base^P_DIGITS, indexed by digit count - 1
+            alignas(64) uint32_t powArr[BATCH] = {};
+            for (int i = 0; i < R::P_DIGITS && !R::POW2; ++i) {
+                powArr[i] = static_cast<uint32_t>(ipow(Base, i + 1));
+            }
+            const __m512i one = _mm512_set1_epi32(1);
+            const __m512i powTable = _mm512_load_si512(powArr);
+            const __m512i base = _mm512_set1_epi32(Base);
+            const __m512i maxDigits = _mm512_set1_epi32(R::DIGITS);
+
+            CalcResult result = {0, 0, 0};
+            simd::Best16x64 best;
+
+            kBegin = std::max(kBegin, 1);
+            kEnd = static_cast<int>(std::min<int64_t>(kEnd, int64_t{R::K_LIMIT} - 1));
+            __m512i kVec = simd::kLanes16(kBegin);
+            for (int k = kBegin; k <= kEnd; k += BATCH, kVec = _mm512_add_epi32(kVec, _mm512_set1_epi32(BATCH))) {
+                __mmask16 active = simd::inRange16(kVec, kEnd);
+
+                __m512i digits = _mm512_setzero_si512();
+                __m512i maskVec = _mm512_setzero_si512();
+                __m512i nVec = _mm512_setzero_si512();
+                __m512i concatLo = _mm512_setzero_si512();
+                __m512i concatHi = _mm512_setzero_si512();
+                __mmask16 bad = 0;
+
+                for (int n = 1; n <= R::MAX_N; ++n) {
+                    __m512i p = _mm512_mullo_epi32(kVec, _mm512_set1_epi32(n));
+
+                    // Digit count: 1 + number of powers Base^i <= p (unsigned compares)
+                    __m512i pDigits = one;
+                    for (int i = 1; i < R::P_DIGITS; ++i) {
+                        __mmask16 ge = _mm512_cmp_epu32_mask(
+                            p, _mm512_set1_epi32(static_cast<int>(ipow(Base, i))), _MM_CMPINT_NLT);
+                        pDigits = _mm512_mask_add_epi32(pDigits, ge, pDigits, one);
+                    }
+
+                    // Lanes freeze for good once a product no longer fits
+                    __m512i newDigits = _mm512_add_epi32(digits, pDigits);
+                    active &= _mm512_cmp_epi32_mask(newDigits, maxDigits, _MM_CMPINT_LE);
+                    if (!active) break;
+
+                    __m512i v = p;
+                    for (int i = 0; i < R::P_DIGITS; ++i) {
+                        __mmask16 live = _mm512_mask_test_epi32_mask(active, v, v);
+                        __m512i q = divBase<R>(v);
+                        __m512i digit = _mm512_sub_epi32(v, _mm512_mullo_epi32(q, base));
+                        __m512i bit = _mm512_sllv_epi32(one, digit);
+                        bad |= _mm512_mask_test_epi32_mask(live, maskVec, bit);
+                        maskVec = _mm512_mask_or_epi32(maskVec, live, maskVec, bit);
+                        v = q;
+                    }
+
+                    // concat = concat * Base^pDigits + p in 64-bit lanes
+                    __m512i shiftedLo, shiftedHi;
+                    if constexpr (R::POW2) {
+                        __m512i bits = _mm512_mullo_epi32(pDigits, _mm512_set1_epi32(R::LOG2));
+                        shiftedLo = _mm512_sllv_epi64(concatLo, lowHalf(bits));
+                        shiftedHi = _mm512_sllv_epi64(concatHi, highHalf(bits));
+                    } else {
+                        __m512i scale = _mm512_permutexvar_epi32(_mm512_sub_epi32(pDigits, one), powTable);
+                        shiftedLo = _mm512_mullo_epi64(concatLo, lowHalf(scale));
+                        shiftedHi = _mm512_mullo_epi64(concatHi, highHalf(scale));
+                    }
+                    concatLo = _mm512_mask_add_epi64(concatLo, static_cast<__mmask8>(active),
+                                                     shiftedLo, lowHalf(p));
+                    concatHi = _mm512_mask_add_epi64(concatHi, static_cast<__mmask8>(active >> 8),
+                                                     shiftedHi, highHalf(p));
+                    digits = _mm512_mask_mov_epi32(digits, active, newDigits);
+                    nVec = _mm512_mask_mov_epi32(nVec, active, _mm512_set1_epi32(n));
+                }
+
+                // Digit 0 maps to bit 0 and is only allowed in zero mode
+                if constexpr (!R::ZERO) bad |= _mm512_test_epi32_mask(maskVec, one);
+                __mmask16 valid = _mm512_cmpeq_epi32_mask(digits, maxDigits)
+                                & _mm512_cmpeq_epi32_mask(maskVec, _mm512_set1_epi32(static_cast<int>(R::FULL_MASK)))
+                                & _mm512_cmp_epi32_mask(nVec, one, _MM_CMPINT_GT)
+                                & static_cast<__mmask16>(~bad);
+
+                simd::update(best, valid, concatLo, concatHi, kVec, nVec);
+            }
+            simd::reduce(best, result);
+            return result;
+        }
+
+        using Kernel = CalcResult (*)(int, int);
+
+        // [zero][base - MIN_BASE]; zero mode stops at MAX_ZERO_BASE
+        const Kernel KERNELS[2][MAX_BASE - MIN_BASE + 1] = {
+            {calcBase<2, false>, calcBase<3, false>, calcBase<4, false>, calcBase<5, false>,
+             calcBase<6, false>, calcBase<7, false>, calcBase<8, false>, calcBase<9, false>,
+             calcBase<10, false>, calcBase<11, false>, calcBase<12, false>, calcBase<13, false>,
+             calcBase<14, false>, calcBase<15, false>, calcBase<16, false>},
+            {calcBase<2, true>, calcBase<3, true>, calcBase<4, true>, calcBase<5, true>,
+             calcBase<6, true>, calcBase<7, true>, calcBase<8, true>, calcBase<9, true>,
+             calcBase<10, true>, calcBase<11, true>, calcBase<12, true>, calcBase<13, true>,
+             calcBase<14, true>, calcBase<15, true>, nullptr},
+        };
+    }
+
+    CalcResult calc(int base, int kBegin, int kEnd, bool zero) {
+        if (!supported(base, zero)) return {0, 0, 0};
+        return KERNELS[zero][base - MIN_BASE](kBegin, kEnd);
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file pandigital_radix_scalar.cpp
+ * @brief Portable base-b reference implementation
+ *
+ * Grows k*1 || k*2 || ... one product at a time with a 64-bit
+ * concatenation and a digit bitmask, like the SIMD kernels do per lane.
+ */
+#include <algorithm>
+#include "radix.h"
+
+namespace impl::radix::scalar {
+    namespace {
+        template <int Base, bool Zero>
+        CalcResult calcBase(int kBegin, int kEnd) {
+            using R = Radix<Base, Zero>;
+            CalcResult result = {0, 0, 0};
+
+            kBegin = std::max(kBegin, 1);
+            kEnd = static_cast<int>(std::min<int64_t>(kEnd, int64_t{R::K_LIMIT} - 1));
+            for (int k = kBegin; k <= kEnd; ++k) {
+                uint64_t concat = 0;
+                uint32_t mask = 0;
+                int digits = 0;
+
+                for (int n = 1; n <= R::MAX_N; ++n) {
+                    uint32_t p = static_cast<uint32_t>(k) * static_cast<uint32_t>(n);
+                    int d = digitsOf(p, Base);
+                    if (digits + d > R::DIGITS) break;
+
+                    bool repeated = false;
+                    for (uint32_t v = p; v != 0; v /= Base) {
+                        uint32_t bit = 1u << (v % Base);
+                        repeated |= (mask & bit) != 0;
+                        mask |= bit;
+                    }
+                    if (repeated || (!R::ZERO && (mask & 1u))) break;
+
+                    concat = concat * ipow(Base, d) + p;
+                    digits += d;
+                    if (digits == R::DIGITS) {
+                        if (n >= 2 && mask == R::FULL_MASK) mergeMax(result, {concat, k, n});
+                        break;
+                    }
+                }
+            }
+            return result;
+        }
+
+        using Kernel = CalcResult (*)(int, int);
+
+        // [zero][base - MIN_BASE]; zero mode stops at MAX_ZERO_BASE
+        const Kernel KERNELS[2][MAX_BASE - MIN_BASE + 1] = {
+            {calcBase<2, false>, calcBase<3, false>, calcBase<4, false>, calcBase<5, false>,
+             calcBase<6, false>, calcBase<7, false>, calcBase<8, false>, calcBase<9, false>,
+             calcBase<10, false>, calcBase<11, false>, calcBase<12, false>, calcBase<13, false>,
+             calcBase<14, false>, calcBase<15, false>, calcBase<16, false>},
+            {calcBase<2, true>, calcBase<3, true>, calcBase<4, true>, calcBase<5, true>,
+             calcBase<6, true>, calcBase<7, true>, calcBase<8, true>, calcBase<9, true>,
+             calcBase<10, true>, calcBase<11, true>, calcBase<12, true>, calcBase<13, true>,
+             calcBase<14, true>, calcBase<15, true>, nullptr},
+        };
+    }
+
+    CalcResult calc(int base, int kBegin, int kEnd, bool zero) {
+        if (!supported(base, zero)) return {0, 0, 0};
+        return KERNELS[zero][base - MIN_BASE](kBegin, kEnd);
+    }
+}
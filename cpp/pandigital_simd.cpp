@@ -14,15 +14,20 @@
  * Performance characteristics:
  * - Time complexity: O((n/8) * log n)
  * - Memory alignment: 32-byte boundaries
- * - Cache usage: ~96 bytes of aligned buffers
+ * - Cache usage: ~320 bytes of aligned buffers
  */
 #include <immintrin.h>
 #include <iostream>
 #include <algorithm>
 #include <cstdio>
+#include <vector>
 #include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
 
 namespace impl::base_simd {
+    constexpr int MAX_K = 9999;
+
     /**
      * @brief Validates if a character array represents a pandigital number
      * @param s Pointer to 9-character array
@@ -44,27 +49,24 @@ namespace impl::base_simd {
     }
 
     /**
-     * @brief Calculates largest pandigital number using SIMD operations
-     * @return CalcResult with maximum value and corresponding k
-     * 
+     * @brief Passes every hit with k in [kBegin, kEnd] to onHit(value, k, n), in k order
+     *
      * Implementation steps:
      * 1. Process numbers in batches of 8 using AVX2
-     * 2. Perform parallel multiplication
-     * 3. Convert results to string and validate
-     * 4. Track maximum valid pandigital number
+     * 2. Perform parallel multiplication by 1..9
+     * 3. Append products to a string until it reaches 9 digits and validate
      */
-    CalcResult calc() {
-        constexpr int MAX_K = 9999;
-        CalcResult result = {0, 0, 2}; // Initialize with maxVal=0, bestK=0, bestN=2
+    template <typename OnHit>
+    void scan(int kBegin, int kEnd, OnHit&& onHit) {
+        constexpr int MAX_N = 9;
 
         alignas(32) int kArr[8];
 
-        __m256i two = _mm256_set1_epi32(2);
-
-        for (int k = 1; k <= MAX_K; k += 8) {
-            int prod2[8];
-            int prod1[8];
-            int batchSize = std::min(8, MAX_K - k + 1);
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; k += 8) {
+            alignas(32) int prod[MAX_N][8];
+            int batchSize = std::min(8, kEnd - k + 1);
             // Prepare k values
             for (int i = 0; i < batchSize; i++) {
                 kArr[i] = k + i;
@@ -76,36 +78,76 @@ namespace impl::base_simd {
             // Load k values (unaligned loads)
             __m256i kVec = _mm256_loadu_si256(reinterpret_cast<__m256i *>(kArr));
 
-            // Compute k*1 and k*2
-            __m256i prodVec1 = kVec;
-            __m256i prodVec2 = _mm256_mullo_epi32(kVec, two);
-
-            // Store results back
-            _mm256_storeu_si256(reinterpret_cast<__m256i *>(prod1), prodVec1);
-            _mm256_storeu_si256(reinterpret_cast<__m256i *>(prod2), prodVec2);
+            // Compute k*1 .. k*9 and store results back
+            for (int n = 1; n <= MAX_N; n++) {
+                __m256i prodVec = _mm256_mullo_epi32(kVec, _mm256_set1_epi32(n));
+                _mm256_store_si256(reinterpret_cast<__m256i *>(prod[n - 1]), prodVec);
+            }
 
             // Scalar check
             for (int i = 0; i < batchSize; i++) {
-                int p1 = prod1[i];
-                int p2 = prod2[i];
-                char s[10];
+                char s[16];
+                int len = 0;
 
                 // Using snprintf instead of std::to_string or stringstream for performance
                 // in this hot loop. Modern C++ alternatives would involve heap allocations
                 // which are significantly slower in this performance-critical section.
-                int len = std::snprintf(s, sizeof(s), "%d%d", p1, p2);
-                if (len < 0 || len >= sizeof(s)) continue;  // Error or truncation occurred
-                if (len != 9) continue;
-                if (isPandigital(s)) {
-                    int val = std::atoi(s);
-                    if (val > result.maxVal) {
-                        result.maxVal = val;
-                        result.bestK = kArr[i];
-                    }
+                for (int n = 1; n <= MAX_N; n++) {
+                    int written = std::snprintf(s + len, sizeof(s) - len, "%d", prod[n - 1][i]);
+                    if (written < 0 || len + written > 9) break;  // Error or too many digits
+                    len += written;
+                    if (n < 2 || len != 9) continue;
+                    if (isPandigital(s)) onHit(std::atoi(s), kArr[i], n);
+                    break;
                 }
             }
         }
+    }
 
+    /**
+     * @brief Calculates largest pandigital number using SIMD operations
+     * @param kBegin First k to test (inclusive)
+     * @param kEnd Last k to test (inclusive, clamped to MAX_K)
+     * @return CalcResult with maximum value and the k, n producing it
+     */
+    CalcResult calc(int kBegin, int kEnd) {
+        CalcResult result = {0, 0, 0}; // Initialize with maxVal=0, bestK=0, bestN=0
+        scan(kBegin, kEnd, [&result](int val, int k, int n) {
+            if (static_cast<uint64_t>(val) > result.maxVal) {
+                result.maxVal = val;
+                result.bestK = k;
+                result.bestN = n;
+            }
+        });
         return result;
     }
+
+    /**
+     * @brief Appends every pandigital concatenated product with k in [kBegin, kEnd] to out
+     */
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        scan(kBegin, kEnd, [&out](int val, int k, int n) { out.push(val, k, n); });
+    }
+
+    /**
+     * @brief Keeps the best heap.capacity() hits with k in [kBegin, kEnd]
+     */
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        scan(kBegin, kEnd, [&heap](int val, int k, int n) {
+            if (val >= heap.threshold()) heap.offer({val, k, n});
+        });
+    }
+
+    /**
+     * @brief Returns the count largest pandigital concatenated products, best first
+     */
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
 }
\ No newline at end of file
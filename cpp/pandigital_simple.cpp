@@ -12,9 +12,15 @@
  */
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
 
 namespace impl::simple {
+    constexpr int MAX_K = 9999;
+
     /**
      * @brief Checks if a string represents a 1-9 pandigital number
      * @param s String to check
@@ -40,28 +46,99 @@ namespace impl::simple {
     }
 
     /**
-     * @brief Calculates the largest pandigital number from concatenated k and 2k
-     * @return CalcResult containing the maximum value and corresponding k
+     * @brief Calculates the largest pandigital concatenated product k*1 || k*2 || ... || k*n
+     * @param kBegin First k to test (inclusive)
+     * @param kEnd Last k to test (inclusive)
+     * @return CalcResult containing the maximum value and the k, n producing it
+     *
+     * The concatenation is grown one multiplier at a time, so each k is
+     * visited once for every n in 2..9 until it reaches 9 digits.
+     * k above MAX_K has 5+ digits and can never produce 9 digits with n >= 2.
      */
-    CalcResult calc() {
-        CalcResult result = {0, 0, 2}; // maxVal=0, bestK=0, bestN=2
-
-        for (int k = 1; k < 10000; ++k) {
-            int p1 = k;
-            int p2 = k * 2;
-            std::string concat = std::to_string(p1) + std::to_string(p2);
-            
-            if (concat.length() != 9) continue;
-            
-            if (isPandigital(concat)) {
-                int val = std::stoi(concat);
-                if (val > result.maxVal) {
-                    result.maxVal = val;
-                    result.bestK = k;
+    CalcResult calc(int kBegin, int kEnd) {
+        constexpr int MAX_N = 9;
+        CalcResult result = {0, 0, 0}; // maxVal=0, bestK=0, bestN=0
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; ++k) {
+            std::string concat = std::to_string(k);
+
+            for (int n = 2; n <= MAX_N && concat.length() < 9; ++n) {
+                concat += std::to_string(k * n);
+
+                if (concat.length() != 9) continue;
+
+                if (isPandigital(concat)) {
+                    int val = std::stoi(concat);
+                    if (static_cast<uint64_t>(val) > result.maxVal) {
+                        result.maxVal = val;
+                        result.bestK = k;
+                        result.bestN = n;
+                    }
                 }
             }
         }
 
         return result;
     }
+
+    /**
+     * @brief Appends every pandigital concatenated product with k in [kBegin, kEnd] to out
+     *
+     * Same walk as calc(); serves as the reference for the SIMD enumerators.
+     */
+    void enumerate(int kBegin, int kEnd, hits::HitBuffer& out) {
+        constexpr int MAX_N = 9;
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; ++k) {
+            std::string concat = std::to_string(k);
+
+            for (int n = 2; n <= MAX_N && concat.length() < 9; ++n) {
+                concat += std::to_string(k * n);
+                if (concat.length() == 9 && isPandigital(concat)) {
+                    out.push(std::stoi(concat), k, n);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Keeps the best heap.capacity() hits with k in [kBegin, kEnd]
+     */
+    void topK(int kBegin, int kEnd, hits::TopK& heap) {
+        constexpr int MAX_N = 9;
+
+        kBegin = std::max(kBegin, 1);
+        kEnd = std::min(kEnd, MAX_K);
+        for (int k = kBegin; k <= kEnd; ++k) {
+            std::string concat = std::to_string(k);
+
+            for (int n = 2; n <= MAX_N && concat.length() < 9; ++n) {
+                concat += std::to_string(k * n);
+                if (concat.length() == 9 && isPandigital(concat)) {
+                    int val = std::stoi(concat);
+                    if (val >= heap.threshold()) heap.offer({val, k, n});
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the count largest pandigital concatenated products, best first
+     */
+    std::vector<hits::Hit> calcTopK(size_t count) {
+        hits::TopK heap(count);
+        topK(1, MAX_K, heap);
+        return heap.sorted();
+    }
+
+    /**
+     * @brief Calculates the largest pandigital concatenated product over k = 1..MAX_K
+     */
+    CalcResult calc() {
+        return calc(1, MAX_K);
+    }
 }
\ No newline at end of file
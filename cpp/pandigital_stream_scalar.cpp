@@ -0,0 +1,104 @@
+/**
+ * @file pandigital_stream_scalar.cpp
+ * @brief Portable 64-bit kernel of the streaming search
+ *
+ * The radix scalar loop with k, products and concatenation widened to
+ * 64 bits; the digit bitmask rejects a product as soon as it repeats a
+ * digit (or contains 0 outside zero mode). calc() folds the hits into the
+ * best one, enumerate() hands each to a callback.
+ */
+#include <algorithm>
+#include "stream.h"
+
+namespace impl::stream::scalar {
+    namespace {
+        // Calls onHit with every hit in [kBegin, kEnd], ascending k
+        template <int Base, bool Zero, typename OnHit>
+        void scan(uint64_t kBegin, uint64_t kEnd, OnHit&& onHit) {
+            using S = Space<Base, Zero>;
+
+            kBegin = std::max<uint64_t>(kBegin, 1);
+            kEnd = std::min(kEnd, S::K_LIMIT - 1);
+            for (uint64_t k = kBegin; k <= kEnd; ++k) {
+                uint64_t concat = 0;
+                uint32_t mask = 0;
+                int digits = 0;
+
+                for (int n = 1; n <= S::MAX_N; ++n) {
+                    const uint64_t p = k * static_cast<uint64_t>(n);
+
+                    // Distinct allowed digits cannot exceed DIGITS, so no length check
+                    uint64_t scale = 1;
+                    int d = 0;
+                    bool repeated = false;
+                    for (uint64_t v = p; v != 0 && !repeated; v /= Base) {
+                        const uint32_t bit = 1u << (v % Base);
+                        repeated = (mask & bit) != 0 || (S::FULL_MASK & bit) == 0;
+                        mask |= bit;
+                        scale *= Base;
+                        ++d;
+                    }
+                    if (repeated) break;
+
+                    concat = concat * scale + p;
+                    digits += d;
+                    if (digits == S::DIGITS) {
+                        if (n >= 2) onHit(Result{concat, k, n});
+                        break;
+                    }
+                }
+            }
+        }
+
+        template <int Base, bool Zero>
+        Result calcBase(uint64_t kBegin, uint64_t kEnd) {
+            Result result;
+            scan<Base, Zero>(kBegin, kEnd, [&result](const Result& hit) { merge(result, hit); });
+            return result;
+        }
+
+        template <int Base, bool Zero>
+        void enumerateBase(uint64_t kBegin, uint64_t kEnd, const HitFn& onHit) {
+            scan<Base, Zero>(kBegin, kEnd, onHit);
+        }
+
+        using Kernel = Result (*)(uint64_t, uint64_t);
+        using Enumerator = void (*)(uint64_t, uint64_t, const HitFn&);
+
+        // [zero][base - 2]
+        const Kernel KERNELS[2][15] = {
+            {calcBase<2, false>, calcBase<3, false>, calcBase<4, false>, calcBase<5, false>,
+             calcBase<6, false>, calcBase<7, false>, calcBase<8, false>, calcBase<9, false>,
+             calcBase<10, false>, calcBase<11, false>, calcBase<12, false>, calcBase<13, false>,
+             calcBase<14, false>, calcBase<15, false>, calcBase<16, false>},
+            {calcBase<2, true>, calcBase<3, true>, calcBase<4, true>, calcBase<5, true>,
+             calcBase<6, true>, calcBase<7, true>, calcBase<8, true>, calcBase<9, true>,
+             calcBase<10, true>, calcBase<11, true>, calcBase<12, true>, calcBase<13, true>,
+             calcBase<14, true>, calcBase<15, true>, calcBase<16, true>},
+        };
+
+        // [zero][base - 2]
+        const Enumerator ENUMERATORS[2][15] = {
+            {enumerateBase<2, false>, enumerateBase<3, false>, enumerateBase<4, false>,
+             enumerateBase<5, false>, enumerateBase<6, false>, enumerateBase<7, false>,
+             enumerateBase<8, false>, enumerateBase<9, false>, enumerateBase<10, false>,
+             enumerateBase<11, false>, enumerateBase<12, false>, enumerateBase<13, false>,
+             enumerateBase<14, false>, enumerateBase<15, false>, enumerateBase<16, false>},
+            {enumerateBase<2, true>, enumerateBase<3, true>, enumerateBase<4, true>,
+             enumerateBase<5, true>, enumerateBase<6, true>, enumerateBase<7, true>,
+             enumerateBase<8, true>, enumerateBase<9, true>, enumerateBase<10, true>,
+             enumerateBase<11, true>, enumerateBase<12, true>, enumerateBase<13, true>,
+             enumerateBase<14, true>, enumerateBase<15, true>, enumerateBase<16, true>},
+        };
+    }
+
+    Result calc(int base, bool zero, uint64_t kBegin, uint64_t kEnd) {
+        if (!supported(base)) return {};
+        return KERNELS[zero][base - 2](kBegin, kEnd);
+    }
+
+    void enumerate(int base, bool zero, uint64_t kBegin, uint64_t kEnd, const HitFn& onHit) {
+        if (!supported(base)) return;
+        ENUMERATORS[zero][base - 2](kBegin, kEnd, onHit);
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file parallel.h
+ * @brief Multi-threaded k-range driver for the pandigital engines
+ *
+ * The k range is cut into fixed-size chunks that workers claim from a
+ * shared counter. Every worker folds its chunks into a thread-local
+ * CalcResult and the partial results are merged with mergeMax, so the
+ * answer does not depend on the thread count or scheduling.
+ *
+ * enumerate() uses the same chunking but streams every hit: each worker
+ * fills its own HitBuffer and only full buffers cross threads. topK()
+ * gives every worker its own bounded heap and merges them at the end.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "calc_result.h"
+#include "hits.h"
+#include "topk.h"
+
+namespace impl::parallel {
+    /// Range kernel searching k in [kBegin, kEnd] (inclusive)
+    using RangeKernel = std::function<CalcResult(int kBegin, int kEnd)>;
+
+    /// Enumerating kernel appending every hit with k in [kBegin, kEnd] to out
+    using EnumerateKernel = std::function<void(int kBegin, int kEnd, hits::HitBuffer& out)>;
+
+    /// Top-K kernel offering hits with k in [kBegin, kEnd] to heap
+    using TopKKernel = std::function<void(int kBegin, int kEnd, hits::TopK& heap)>;
+
+    /// Default chunk: 2048 k values keep every kernel's working set in L1
+    constexpr int DEFAULT_CHUNK = 2048;
+
+    /// Chunk used when a call passes chunk <= 0; DEFAULT_CHUNK unless tuned
+    int defaultChunk();
+
+    /// Sets defaultChunk(), e.g. from a tuning profile; values <= 0 restore DEFAULT_CHUNK
+    void setDefaultChunk(int chunk);
+
+    /**
+     * @class ThreadPool
+     * @brief Fixed set of workers that all run the same job per dispatch
+     *
+     * The calling thread takes part as worker 0, so a pool of size 1
+     * spawns no threads at all.
+     */
+    class ThreadPool {
+    public:
+        explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Number of workers including the calling thread
+        unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        /// Runs job(worker) on every worker and blocks until all have returned
+        void run(const std::function<void(unsigned worker)>& job);
+
+    private:
+        void workerLoop(unsigned worker);
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void(unsigned)>* job = nullptr;
+        uint64_t generation = 0;
+        unsigned pending = 0;
+        bool stopping = false;
+    };
+
+    /// Process-wide pool sized to the hardware concurrency
+    ThreadPool& defaultPool();
+
+    /**
+     * @brief Searches [kBegin, kEnd] with kernel on every worker of pool
+     * @param pool Workers to run on
+     * @param kernel Range kernel, e.g. impl::avx2::calc
+     * @param kBegin First k (inclusive)
+     * @param kEnd Last k (inclusive)
+     * @param chunk Number of k values claimed per step, <= 0 for defaultChunk()
+     * @return Merged result, identical for any pool size
+     */
+    CalcResult calc(ThreadPool& pool, const RangeKernel& kernel,
+                    int kBegin, int kEnd, int chunk = 0);
+
+    /// Same as above on defaultPool()
+    CalcResult calc(const RangeKernel& kernel, int kBegin, int kEnd,
+                    int chunk = 0);
+
+    /**
+     * @brief Streams every hit in [kBegin, kEnd] to sink
+     * @param sink Receives blocks of hits; calls are serialized, but blocks
+     *             arrive in no particular order
+     * @return Number of hits delivered
+     */
+    uint64_t enumerate(ThreadPool& pool, const EnumerateKernel& kernel,
+                       int kBegin, int kEnd, const hits::Sink& sink,
+                       int chunk = 0);
+
+    /// Collects every hit in [kBegin, kEnd], sorted with hits::greater
+    std::vector<hits::Hit> collect(ThreadPool& pool, const EnumerateKernel& kernel,
+                                   int kBegin, int kEnd, int chunk = 0);
+
+    /**
+     * @brief Returns the count best hits in [kBegin, kEnd], best first
+     *
+     * Identical for any pool size: every worker keeps its own count best
+     * and the union of those always contains the global count best.
+     */
+    std::vector<hits::Hit> topK(ThreadPool& pool, const TopKKernel& kernel, size_t count,
+                                int kBegin, int kEnd, int chunk = 0);
+}
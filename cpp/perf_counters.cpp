@@ -0,0 +1,157 @@
+/**
+ * @file perf_counters.cpp
+ * @brief perf_event_open backend for bench::perf
+ *
+ * Each event is a separate (non-group) counter so that a missing event,
+ * e.g. a raw uop event on a non-Intel PMU or L1D misses inside some VMs,
+ * does not disable the others. Values are scaled by
+ * time_enabled / time_running when the kernel multiplexes counters.
+ */
+#include "perf_counters.h"
+#include "cpu_features.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench::perf {
+    const char* eventName(Event e) {
+        switch (e) {
+            case CYCLES: return "cycles";
+            case INSTRUCTIONS: return "instructions";
+            case BRANCH_MISSES: return "branch-misses";
+            case L1D_MISSES: return "L1D-misses";
+            case UOPS: return "uops";
+            default: return "?";
+        }
+    }
+
+    bool Counts::any() const {
+        for (bool a : available) {
+            if (a) return true;
+        }
+        return false;
+    }
+
+    double Counts::ipc() const {
+        if (!available[CYCLES] || !available[INSTRUCTIONS] || value[CYCLES] <= 0) return 0;
+        return value[INSTRUCTIONS] / value[CYCLES];
+    }
+
+    double Counts::perCandidate(Event e, uint64_t candidates) const {
+        if (!available[e] || calls == 0 || candidates == 0) return 0;
+        return value[e] / static_cast<double>(calls) / static_cast<double>(candidates);
+    }
+
+#if defined(__linux__)
+    namespace {
+        int openEvent(uint32_t type, uint64_t config) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        std::string paranoidLevel() {
+            std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+            std::string level;
+            if (in >> level) return level;
+            return "?";
+        }
+    }
+
+    CounterSet::CounterSet() {
+        const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        int firstErr = fds[CYCLES] < 0 ? errno : 0;
+        fds[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE, l1dReadMiss);
+        // UOPS_ISSUED.ANY (event 0x0E, umask 0x01) has this encoding on Intel cores only
+        fds[UOPS] = impl::cpu::vendor() == "GenuineIntel" ? openEvent(PERF_TYPE_RAW, 0x010E) : -1;
+
+        if (!usable()) {
+            reason = std::string("perf_event_open failed (") + std::strerror(firstErr) +
+                     ", perf_event_paranoid=" + paranoidLevel() + ")";
+        } else {
+            for (int e = 0; e < EVENT_COUNT; ++e) {
+                if (fds[e] >= 0) continue;
+                if (!reason.empty()) reason += ", ";
+                reason += eventName(static_cast<Event>(e));
+            }
+            if (!reason.empty()) reason = "unsupported events: " + reason;
+        }
+    }
+
+    CounterSet::~CounterSet() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool CounterSet::usable() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    Counts CounterSet::measure(const std::function<void()>& fn, uint64_t calls) {
+        Counts counts;
+        counts.calls = calls;
+
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        for (uint64_t i = 0; i < calls; ++i) fn();
+        for (int fd : fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        for (int e = 0; e < EVENT_COUNT; ++e) {
+            if (fds[e] < 0) continue;
+            uint64_t data[3];   // value, time_enabled, time_running
+            if (read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            if (data[2] == 0) continue;   // never scheduled on the PMU
+            counts.available[e] = true;
+            counts.value[e] = static_cast<double>(data[0]) *
+                              static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        return counts;
+    }
+#else
+    CounterSet::CounterSet() {
+        for (int& fd : fds) fd = -1;
+        reason = "hardware counters are only supported on Linux";
+    }
+
+    CounterSet::~CounterSet() = default;
+
+    bool CounterSet::usable() const {
+        return false;
+    }
+
+    Counts CounterSet::measure(const std::function<void()>& fn, uint64_t calls) {
+        Counts counts;
+        counts.calls = calls;
+        for (uint64_t i = 0; i < calls; ++i) fn();
+        return counts;
+    }
+#endif
+}
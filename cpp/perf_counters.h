@@ -0,0 +1,71 @@
+/**
+ * @file perf_counters.h
+ * @brief Optional hardware performance counters (Linux perf_event_open)
+ *
+ * Counters are opened per event on the calling thread, user space only,
+ * so they work with perf_event_paranoid <= 2. Events the kernel or PMU
+ * refuses are reported as unavailable instead of failing the run; on
+ * non-Linux builds every event is unavailable.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace bench::perf {
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        UOPS,          ///< Intel UOPS_ISSUED.ANY raw event, Intel CPUs only
+        EVENT_COUNT
+    };
+
+    /// Column label of an event, e.g. "branch-misses"
+    const char* eventName(Event e);
+
+    /**
+     * @struct Counts
+     * @brief Totals for one measured region, scaled for multiplexing
+     */
+    struct Counts {
+        bool available[EVENT_COUNT] = {};
+        double value[EVENT_COUNT] = {};
+        uint64_t calls = 0;           ///< Calls covered by the counts
+
+        bool any() const;
+        /// Instructions per cycle, 0 if either counter is missing
+        double ipc() const;
+        /// Count of e per call divided by candidates, 0 if unavailable
+        double perCandidate(Event e, uint64_t candidates) const;
+    };
+
+    /**
+     * @class CounterSet
+     * @brief Opens the events once and measures arbitrary regions
+     */
+    class CounterSet {
+    public:
+        CounterSet();
+        ~CounterSet();
+
+        CounterSet(const CounterSet&) = delete;
+        CounterSet& operator=(const CounterSet&) = delete;
+
+        /// True if at least one event could be opened
+        bool usable() const;
+
+        /// Why events are missing (empty if all opened)
+        const std::string& status() const { return reason; }
+
+        /// Runs fn `calls` times with the counters enabled
+        Counts measure(const std::function<void()>& fn, uint64_t calls);
+
+    private:
+        int fds[EVENT_COUNT];
+        std::string reason;
+    };
+}
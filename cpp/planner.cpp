@@ -0,0 +1,110 @@
+/**
+ * @file planner.cpp
+ * @brief Interval bounds by binary search over the monotone concatenation
+ *
+ * Planning costs a few dozen concatLength/concat evaluations per n, far
+ * below one kernel batch.
+ */
+#include <algorithm>
+#include "planner.h"
+
+namespace impl::planner {
+    namespace {
+        constexpr int DIGITS = 9;
+
+        int digitsOf(uint64_t v) {
+            int d = 1;
+            for (; v >= 10; v /= 10) ++d;
+            return d;
+        }
+
+        // Smallest / largest d-digit numbers with distinct nonzero digits
+        int smallestDistinct(int d) {
+            int v = 0;
+            for (int i = 1; i <= d; ++i) v = v * 10 + i;
+            return v;
+        }
+
+        int largestDistinct(int d) {
+            int v = 0;
+            for (int i = 9; i > 9 - d; --i) v = v * 10 + i;
+            return v;
+        }
+
+        // First k in [lo, hi] with pred(k), hi + 1 if none; pred must be monotone
+        template <typename Pred>
+        int firstTrue(int lo, int hi, Pred pred) {
+            int end = hi + 1;
+            while (lo < end) {
+                int mid = lo + (end - lo) / 2;
+                if (pred(mid)) {
+                    end = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            return end;
+        }
+    }
+
+    int concatLength(int k, int n) {
+        int length = 0;
+        for (int i = 1; i <= n; ++i) length += digitsOf(static_cast<uint64_t>(k) * i);
+        return length;
+    }
+
+    uint64_t concat(int k, int n) {
+        uint64_t v = 0;
+        for (int i = 1; i <= n; ++i) {
+            uint64_t p = static_cast<uint64_t>(k) * i;
+            for (int d = digitsOf(p); d > 0; --d) v *= 10;
+            v += p;
+        }
+        return v;
+    }
+
+    Interval interval(int n, int kBegin, int kEnd, uint64_t best) {
+        Interval r = {n, std::max(kBegin, 1), std::min(kEnd, MAX_K)};
+        if (r.empty() || n < MIN_N || n > MAX_N) return {n, 1, 0};
+
+        // Exactly 9 digits: the length is non-decreasing in k
+        r.kBegin = firstTrue(r.kBegin, r.kEnd, [n](int k) { return concatLength(k, n) >= DIGITS; });
+        r.kEnd = firstTrue(r.kBegin, r.kEnd, [n](int k) { return concatLength(k, n) > DIGITS; }) - 1;
+        if (r.empty()) return r;
+
+        // A pandigital k has distinct nonzero digits
+        const int d = digitsOf(r.kBegin);
+        r.kBegin = std::max(r.kBegin, smallestDistinct(d));
+        r.kEnd = std::min(r.kEnd, largestDistinct(d));
+        if (r.empty() || best == 0) return r;
+
+        // Must beat the best so far; concat is increasing in k here
+        r.kBegin = firstTrue(r.kBegin, r.kEnd, [n, best](int k) { return concat(k, n) > best; });
+        return r;
+    }
+
+    CalcResult search(const parallel::RangeKernel& kernel, int kBegin, int kEnd, Report* report) {
+        CalcResult result = {0, 0, 0};
+        if (report) {
+            *report = Report{};
+            report->total = kEnd >= kBegin ? static_cast<uint64_t>(kEnd - kBegin) + 1 : 0;
+        }
+
+        // Larger n means smaller k and a smaller interval; ties in later
+        // intervals have a larger k and would lose in mergeMax anyway
+        for (int n = MAX_N; n >= MIN_N; --n) {
+            Interval iv = interval(n, kBegin, kEnd, result.maxVal);
+            if (iv.empty()) continue;
+            mergeMax(result, kernel(iv.kBegin, iv.kEnd));
+            if (report) {
+                report->intervals.push_back(iv);
+                report->searched += iv.size();
+            }
+        }
+        return result;
+    }
+
+    CalcResult search(const parallel::RangeKernel& kernel, Report* report) {
+        return search(kernel, 1, MAX_K, report);
+    }
+}
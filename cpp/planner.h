@@ -0,0 +1,81 @@
+/**
+ * @file planner.h
+ * @brief Analytic k-interval planner shared by all engines
+ *
+ * The engines scan k = 1..9999 and reject most lanes late, once the
+ * concatenation turns out not to have 9 digits. The planner works out,
+ * for every n = 2..9, the exact k interval whose k*1 || ... || k*n has 9
+ * digits (the length is monotone in k, so it is one interval per n, and
+ * the intervals of different n are disjoint), narrows it to k with
+ * distinct nonzero digits and to k whose concatenation beats the best
+ * value found so far, and hands only those intervals to a range kernel.
+ *
+ * An interval never crosses a power of ten (the length jumps there), so k
+ * has a fixed digit count inside it and the concatenation is strictly
+ * increasing in k; "beats the best" is then a lower bound on k.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "calc_result.h"
+#include "parallel.h"
+
+namespace impl::planner {
+    constexpr int MAX_K = 9999;
+    constexpr int MIN_N = 2;
+    constexpr int MAX_N = 9;
+
+    /**
+     * @struct Interval
+     * @brief k in [kBegin, kEnd] (inclusive) worth searching for one n
+     */
+    struct Interval {
+        int n;
+        int kBegin;
+        int kEnd;
+
+        bool empty() const { return kBegin > kEnd; }
+        uint64_t size() const { return empty() ? 0 : static_cast<uint64_t>(kEnd - kBegin) + 1; }
+    };
+
+    /**
+     * @struct Report
+     * @brief What a planned search handed to the kernel
+     */
+    struct Report {
+        std::vector<Interval> intervals;   ///< Non-empty intervals in search order
+        uint64_t total = 0;                ///< k values in the requested range
+        uint64_t searched = 0;             ///< k values passed to the kernel
+
+        uint64_t eliminated() const { return total - searched; }
+    };
+
+    /// Number of digits of k*1 || k*2 || ... || k*n
+    int concatLength(int k, int n);
+
+    /// k*1 || k*2 || ... || k*n as a number (only meaningful up to 18 digits)
+    uint64_t concat(int k, int n);
+
+    /**
+     * @brief Exact k interval for n within [kBegin, kEnd]
+     * @param best Only keep k whose 9-digit concatenation exceeds this value
+     * @return Possibly empty interval
+     */
+    Interval interval(int n, int kBegin, int kEnd, uint64_t best = 0);
+
+    /**
+     * @brief Runs kernel over the planned intervals of [kBegin, kEnd]
+     * @param report Receives the intervals and the elimination count if non-null
+     * @return Same result as kernel(kBegin, kEnd)
+     *
+     * Intervals are searched from n = 9 down to n = 2, i.e. smallest
+     * first, and each one is narrowed by the best value found so far.
+     */
+    CalcResult search(const parallel::RangeKernel& kernel, int kBegin, int kEnd,
+                      Report* report = nullptr);
+
+    /// Same as above over k = 1..MAX_K
+    CalcResult search(const parallel::RangeKernel& kernel, Report* report = nullptr);
+}
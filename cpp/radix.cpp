@@ -0,0 +1,66 @@
+/**
+ * @file radix.cpp
+ * @brief Kernel selection and helpers for the base-b search
+ *
+ * Compiled without ISA flags, like dispatch.cpp: it only checks the CPU
+ * and calls into the kernel libraries.
+ */
+#include <algorithm>
+#include "radix.h"
+#include "cpu_features.h"
+#include "parallel.h"
+
+namespace impl::radix {
+    namespace {
+        using Kernel = CalcResult (*)(int, int, int, bool);
+
+        struct Selection {
+            Kernel kernel;
+            const char* name;
+        };
+
+        const Selection& selection() {
+            static const Selection chosen = [] {
+                const auto& f = cpu::features();
+                if (f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl) {
+                    return Selection{avx512::calc, "AVX-512"};
+                }
+                if (f.avx2) return Selection{avx2::calc, "AVX2"};
+                return Selection{scalar::calc, "Scalar"};
+            }();
+            return chosen;
+        }
+    }
+
+    int maxK(int base, bool zero) {
+        if (!supported(base, zero)) return 0;
+        const int digits = zero ? base : base - 1;
+        return static_cast<int>(ipow(base, digits / 2)) - 1;
+    }
+
+    std::string toString(uint64_t v, int base) {
+        const char* DIGITS = "0123456789ABCDEF";
+        std::string s;
+        do {
+            s += DIGITS[v % base];
+            v /= base;
+        } while (v != 0);
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+
+    const char* kernelName() {
+        return selection().name;
+    }
+
+    CalcResult calc(int base, int kBegin, int kEnd, bool zero) {
+        return selection().kernel(base, kBegin, kEnd, zero);
+    }
+
+    CalcResult calc(int base, bool zero) {
+        // The tuned chunk is measured on the base-10 kernels; keep the fixed one
+        Kernel kernel = selection().kernel;
+        return parallel::calc([kernel, base, zero](int lo, int hi) { return kernel(base, lo, hi, zero); },
+                              1, maxK(base, zero), parallel::DEFAULT_CHUNK);
+    }
+}
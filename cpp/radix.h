@@ -0,0 +1,113 @@
+/**
+ * @file radix.h
+ * @brief Pandigital concatenated products in bases 2..16
+ *
+ * A base-b 1-to-(b-1) pandigital uses every nonzero base-b digit exactly
+ * once, so k*1 || k*2 || ... || k*n has b-1 digits: up to 60 bits in
+ * hexadecimal. The products k*n still fit 32 bits (k < b^((b-1)/2)), so
+ * the kernels keep products, digit counts and digit masks in 32-bit lanes
+ * and only the running concatenation in 64-bit lanes.
+ *
+ * In zero mode the digits 0..b-1 are each used once (b digits, e.g. the
+ * ten-digit 0-9 pandigitals in base 10). The leading-zero rule holds by
+ * construction: k >= 1 and products carry no leading zeros, so a 0 can
+ * only appear inside a product and the value always has exactly b digits.
+ * Zero mode is limited to bases up to 15; in base 16 the products k*n
+ * would no longer fit 32-bit lanes.
+ *
+ * Every kernel is a template on the base and the mode; Radix<Base, Zero>
+ * supplies the digit count, the full mask, the k limit and the product
+ * width as compile-time constants, and a per-TU table maps the runtime
+ * base and mode onto the instances.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "calc_result.h"
+
+namespace impl::radix {
+    constexpr int MIN_BASE = 2;
+    constexpr int MAX_BASE = 16;
+    constexpr int MAX_ZERO_BASE = 15;   ///< Largest base supported in zero mode
+
+    constexpr uint64_t ipow(uint64_t base, int exp) {
+        uint64_t r = 1;
+        for (int i = 0; i < exp; ++i) r *= base;
+        return r;
+    }
+
+    /// Number of base-b digits of v (at least 1)
+    constexpr int digitsOf(uint64_t v, uint64_t base) {
+        int d = 1;
+        while (v >= base) {
+            v /= base;
+            ++d;
+        }
+        return d;
+    }
+
+    /// Number of bits needed to hold v (at least 1)
+    constexpr unsigned bitsOf(uint64_t v) {
+        unsigned bits = 1;
+        while (v >> bits) ++bits;
+        return bits;
+    }
+
+    /**
+     * @struct Radix
+     * @brief Compile-time constants of the base-Base search
+     * @tparam Zero Digits 0..Base-1 instead of 1..Base-1
+     */
+    template <int Base, bool Zero = false>
+    struct Radix {
+        static_assert(Base >= MIN_BASE && Base <= MAX_BASE, "base must be 2..16");
+
+        static constexpr int BASE = Base;
+        static constexpr bool ZERO = Zero;
+        static constexpr int DIGITS = Zero ? Base : Base - 1;      ///< Digits of a pandigital
+        static constexpr uint32_t FULL_MASK = ((1u << Base) - 1) & (Zero ? ~0u : ~1u);
+        static constexpr int MAX_N = DIGITS;                       ///< Bound on n (k = 1 stops first)
+        /// k*1 || k*2 must fit in DIGITS digits, so k < b^(DIGITS / 2)
+        static constexpr uint32_t K_LIMIT = static_cast<uint32_t>(ipow(Base, DIGITS / 2));
+        /// Largest product k*n that is ever formed
+        static constexpr uint64_t P_MAX = uint64_t{K_LIMIT - 1} * MAX_N;
+        static constexpr int P_DIGITS = digitsOf(P_MAX, Base);
+        static constexpr unsigned P_BITS = bitsOf(P_MAX);
+        static constexpr bool POW2 = (Base & (Base - 1)) == 0;
+        static constexpr int LOG2 = static_cast<int>(bitsOf(Base)) - 1;   ///< Only meaningful if POW2
+
+        static_assert(P_MAX <= 0xFFFFFFFFull, "products must fit 32-bit lanes");
+    };
+
+    /// Whether base (and zero mode) is supported
+    constexpr bool supported(int base, bool zero = false) {
+        return base >= MIN_BASE && base <= (zero ? MAX_ZERO_BASE : MAX_BASE);
+    }
+
+    /// Largest k worth testing (0 if the base has no solution space)
+    int maxK(int base, bool zero = false);
+
+    /// Formats v in base (digits 0-9, A-F)
+    std::string toString(uint64_t v, int base);
+
+    namespace scalar {
+        CalcResult calc(int base, int kBegin, int kEnd, bool zero = false);
+    }
+    namespace avx2 {
+        CalcResult calc(int base, int kBegin, int kEnd, bool zero = false);
+    }
+    namespace avx512 {
+        CalcResult calc(int base, int kBegin, int kEnd, bool zero = false);
+    }
+
+    /// Name of the kernel chosen for this CPU ("AVX-512", "AVX2" or "Scalar")
+    const char* kernelName();
+
+    /// Searches k in [kBegin, kEnd] with the best kernel for this CPU
+    CalcResult calc(int base, int kBegin, int kEnd, bool zero = false);
+
+    /// Full search over k = 1..maxK(base, zero) on the parallel driver
+    CalcResult calc(int base, bool zero = false);
+}
@@ -0,0 +1,693 @@
+/**
+ * @file service.cpp
+ * @brief Request parsing, shared-pass batches and the socket loop
+ *
+ * Two threads: the calling thread runs a poll() loop over the listening
+ * socket, a wake-up pipe and the client connections (non-blocking, line
+ * buffered), and an executor thread answers batches on the pool. Replies
+ * come back through the pipe; each connection holds finished replies
+ * until the ones before them are sent, so pipelined requests are answered
+ * in order. Latency is measured from reading a request line to queueing
+ * its reply.
+ */
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include "service.h"
+#include "dispatch.h"
+#include "radix.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace impl::service {
+    namespace {
+        bool parseNumber(const std::string& text, uint64_t& out) {
+            if (text.empty() || text.size() > 19 ||
+                !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                return false;
+            }
+            out = std::strtoull(text.c_str(), nullptr, 10);
+            return true;
+        }
+
+        // "LO-HI" or a single value
+        bool parseRange(const std::string& text, uint64_t& lo, uint64_t& hi) {
+            const size_t dash = text.find('-');
+            if (dash == std::string::npos) {
+                if (!parseNumber(text, lo)) return false;
+                hi = lo;
+                return true;
+            }
+            return parseNumber(text.substr(0, dash), lo) && parseNumber(text.substr(dash + 1), hi);
+        }
+
+        int digitValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // Every hit with k in [lo, hi], best first
+        std::vector<stream::Result> pass(parallel::ThreadPool& pool, int base, bool zero,
+                                         uint64_t lo, uint64_t hi, const std::atomic<bool>* cancel) {
+            if (base != 10 || zero) {
+                return stream::collect(pool, base, zero, lo, hi, stream::DEFAULT_CHUNK, cancel);
+            }
+
+            // Digits 1-9 in base 10 (k <= 9999): the dispatched enumerator
+            // and its tables
+            const dispatch::Engine& engine = dispatch::enumerator();
+            const std::vector<hits::Hit> found =
+                parallel::collect(pool, engine.enumerate, static_cast<int>(lo), static_cast<int>(hi));
+            std::vector<stream::Result> all;
+            all.reserve(found.size());
+            for (const hits::Hit& h : found) {
+                all.push_back({static_cast<uint64_t>(h.value), static_cast<uint64_t>(h.k), h.n});
+            }
+            return all;   // hits::greater is the same order as stream::greater
+        }
+
+        // Fills out with the hits of query, given every hit of a covering pass
+        void select(const Query& query, const std::vector<stream::Result>& all, size_t maxHits, Answer& out) {
+            const size_t limit = query.mode == Mode::Best  ? 1
+                               : query.mode == Mode::Top   ? std::min(query.count, maxHits)
+                                                           : maxHits;
+            for (const stream::Result& h : all) {
+                if (h.bestK < query.kBegin || h.bestK > query.kEnd || h.bestN < query.nMin || h.bestN > query.nMax) {
+                    continue;
+                }
+                if (out.hits.size() == limit) {
+                    out.truncated = query.mode == Mode::Enumerate || query.count > maxHits;
+                    break;
+                }
+                out.hits.push_back(h);
+            }
+        }
+    }
+
+    bool parse(const std::string& line, Query& query, std::string& error) {
+        std::istringstream in(line);
+        std::string word;
+        if (!(in >> word)) {
+            error = "empty request";
+            return false;
+        }
+        Query q;
+        if (word == "best") {
+            q.mode = Mode::Best;
+        } else if (word == "top") {
+            q.mode = Mode::Top;
+        } else if (word == "enumerate") {
+            q.mode = Mode::Enumerate;
+        } else if (word == "status") {
+            q.mode = Mode::Status;
+        } else {
+            error = "unknown request " + word + " (best, top, enumerate or status)";
+            return false;
+        }
+
+        std::string digits, nText, kText, countText;
+        uint64_t v = 0;
+        while (in >> word) {
+            const size_t eq = word.find('=');
+            const std::string key = word.substr(0, eq);
+            const std::string value = eq == std::string::npos ? "" : word.substr(eq + 1);
+            if (eq == std::string::npos || value.empty()) {
+                error = "expected key=value, got " + word;
+                return false;
+            }
+            if (q.mode == Mode::Status || (key == "count" && q.mode != Mode::Top)) {
+                error = "unexpected " + key;
+                return false;
+            }
+            if (key == "base") {
+                if (!parseNumber(value, v) || !stream::supported(static_cast<int>(std::min<uint64_t>(v, 99)))) {
+                    error = "base must be 2..16";
+                    return false;
+                }
+                q.base = static_cast<int>(v);
+            } else if (key == "digits") {
+                digits = value;
+            } else if (key == "n") {
+                nText = value;
+            } else if (key == "k") {
+                kText = value;
+            } else if (key == "count") {
+                countText = value;
+            } else {
+                error = "unknown key " + key;
+                return false;
+            }
+        }
+        if (q.mode == Mode::Status) {
+            query = q;
+            return true;
+        }
+
+        // Digit set: one of the two the kernels search
+        if (!digits.empty()) {
+            uint32_t mask = 0;
+            for (char c : digits) {
+                const int d = digitValue(c);
+                if (d < 0 || d >= q.base || (mask & (1u << d))) {
+                    error = "digits must list distinct base-" + std::to_string(q.base) + " digits";
+                    return false;
+                }
+                mask |= 1u << d;
+            }
+            const uint32_t all = (1u << q.base) - 1;
+            if (mask != all && mask != (all & ~1u)) {
+                error = "digit set must be 1..B-1 or 0..B-1 for base B";
+                return false;
+            }
+            q.zero = mask == all;
+        }
+        const int length = q.zero ? q.base : q.base - 1;
+
+        uint64_t lo = 2, hi = static_cast<uint64_t>(length);
+        if (!nText.empty() && (!parseRange(nText, lo, hi) || lo < 2 || lo > hi || hi > static_cast<uint64_t>(length))) {
+            error = "n must be within 2.." + std::to_string(length);
+            return false;
+        }
+        q.nMin = static_cast<int>(lo);
+        q.nMax = static_cast<int>(hi);
+
+        const uint64_t maxK = stream::maxK(q.base, q.zero);
+        lo = 1;
+        hi = maxK;
+        if (!kText.empty() && (!parseRange(kText, lo, hi) || lo < 1 || lo > hi)) {
+            error = "k must be LO-HI with 1 <= LO <= HI";
+            return false;
+        }
+        q.kBegin = lo;
+        q.kEnd = std::min(hi, maxK);
+
+        if (!countText.empty()) {
+            if (!parseNumber(countText, v) || v < 1) {
+                error = "count must be at least 1";
+                return false;
+            }
+            q.count = static_cast<size_t>(std::min<uint64_t>(v, SIZE_MAX));
+        }
+        query = q;
+        return true;
+    }
+
+    std::vector<Answer> answer(parallel::ThreadPool& pool, const std::vector<Query>& queries,
+                               size_t maxHits, BatchStats* stats, const std::atomic<bool>* cancel) {
+        std::vector<Answer> answers(queries.size());
+        BatchStats local;
+
+        // Queries with something to search, by digit set, then interval start
+        std::vector<size_t> order;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const Query& q = queries[i];
+            if (q.mode == Mode::Status || q.kBegin > q.kEnd) continue;
+            order.push_back(i);
+            local.kRequested += q.kEnd - q.kBegin + 1;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            const Query& x = queries[a];
+            const Query& y = queries[b];
+            if (x.base != y.base) return x.base < y.base;
+            if (x.zero != y.zero) return x.zero < y.zero;
+            return x.kBegin < y.kBegin;
+        });
+
+        // One pass per run of overlapping or touching intervals
+        for (size_t first = 0; first < order.size();) {
+            const Query& head = queries[order[first]];
+            uint64_t hi = head.kEnd;
+            size_t last = first + 1;
+            for (; last < order.size(); ++last) {
+                const Query& q = queries[order[last]];
+                if (q.base != head.base || q.zero != head.zero || q.kBegin > hi + 1) break;
+                hi = std::max(hi, q.kEnd);
+            }
+
+            if (cancel && cancel->load(std::memory_order_relaxed)) break;
+            const std::vector<stream::Result> all = pass(pool, head.base, head.zero, head.kBegin, hi, cancel);
+            ++local.passes;
+            local.kSearched += hi - head.kBegin + 1;
+            for (size_t i = first; i < last; ++i) {
+                select(queries[order[i]], all, maxHits, answers[order[i]]);
+            }
+            first = last;
+        }
+
+        if (stats) *stats = local;
+        return answers;
+    }
+
+    std::string format(const Query& query, const Answer& answer) {
+        std::ostringstream out;
+        if (query.mode == Mode::Best) {
+            if (answer.hits.empty()) return "ok best none\n";
+            const stream::Result& h = answer.hits.front();
+            out << "ok best value=" << radix::toString(h.maxVal, query.base) << " k=" << h.bestK
+                << " n=" << h.bestN << '\n';
+            return out.str();
+        }
+        out << "ok hits=" << answer.hits.size() << (answer.truncated ? " truncated" : "") << '\n';
+        for (const stream::Result& h : answer.hits) {
+            out << radix::toString(h.maxVal, query.base) << ' ' << h.bestK << ' ' << h.bestN << '\n';
+        }
+        return out.str();
+    }
+
+#if defined(_WIN32)
+    bool available() {
+        return false;
+    }
+
+    bool serve(parallel::ThreadPool&, const Options&, std::string& error) {
+        error = "the query service needs Unix domain sockets";
+        return false;
+    }
+#else
+    namespace {
+        constexpr int POLL_MS = 100;
+        constexpr size_t MAX_LINE = 4096;               ///< Longest request line
+        constexpr size_t MAX_OUTPUT = size_t{1} << 20;  ///< Unsent bytes before a connection stops being read
+        constexpr size_t LATENCY_SAMPLES = 8192;        ///< Recent queries behind p50 / p99
+        constexpr int RATE_SECONDS = 10;                ///< Window of the throughput figure
+
+#if defined(MSG_NOSIGNAL)
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;   // A vanished client is an error, not SIGPIPE
+#else
+        constexpr int SEND_FLAGS = 0;
+#endif
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            uint64_t connection;
+            uint64_t seq;
+            Query query;
+            Clock::time_point received;
+        };
+
+        struct Reply {
+            uint64_t connection;
+            uint64_t seq;
+            std::string text;
+            Clock::time_point received;
+            bool query;   ///< Counts towards latency and throughput
+        };
+
+        /**
+         * @struct Exchange
+         * @brief Queues between the socket loop and the executor, plus executor totals
+         */
+        struct Exchange {
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::vector<Job> jobs;
+            std::vector<Reply> replies;
+            bool stopping = false;
+
+            uint64_t batches = 0;
+            uint64_t queries = 0;
+            size_t largestBatch = 0;
+            BatchStats work;
+        };
+
+        /**
+         * @class Meter
+         * @brief Latency percentiles and throughput of recent queries
+         */
+        class Meter {
+        public:
+            explicit Meter(Clock::time_point start) : start(start), samples(LATENCY_SAMPLES) {}
+
+            void record(double us, Clock::time_point now) {
+                samples[total % LATENCY_SAMPLES] = us;
+                ++total;
+                const int64_t second = secondOf(now);
+                const int slot = static_cast<int>(second % RATE_SECONDS);
+                if (slotSecond[slot] != second) {
+                    slotSecond[slot] = second;
+                    slotCount[slot] = 0;
+                }
+                ++slotCount[slot];
+            }
+
+            uint64_t count() const { return total; }
+
+            /// q-quantile (0..1) of the recent latencies in microseconds
+            double percentile(double q) const {
+                std::vector<double> recent(samples.begin(), samples.begin() + std::min<uint64_t>(total, LATENCY_SAMPLES));
+                if (recent.empty()) return 0;
+                auto it = recent.begin() + static_cast<ptrdiff_t>(q * (recent.size() - 1) + 0.5);
+                std::nth_element(recent.begin(), it, recent.end());
+                return *it;
+            }
+
+            /// Queries per second over the last RATE_SECONDS
+            double rate(Clock::time_point now) const {
+                const int64_t second = secondOf(now);
+                uint64_t n = 0;
+                for (int s = 0; s < RATE_SECONDS; ++s) {
+                    if (slotSecond[s] > second - RATE_SECONDS) n += slotCount[s];
+                }
+                const double window = std::min<double>(RATE_SECONDS, std::chrono::duration<double>(now - start).count());
+                return window > 0 ? n / window : 0.0;
+            }
+
+        private:
+            int64_t secondOf(Clock::time_point t) const {
+                return std::chrono::duration_cast<std::chrono::seconds>(t - start).count();
+            }
+
+            Clock::time_point start;
+            std::vector<double> samples;
+            uint64_t total = 0;
+            int64_t slotSecond[RATE_SECONDS] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+            uint64_t slotCount[RATE_SECONDS] = {};
+        };
+
+        struct Connection {
+            int fd;
+            std::string in;
+            std::string out;
+            uint64_t nextSeq = 0;      ///< Sequence number of the next request
+            uint64_t nextReply = 0;    ///< Sequence number of the next reply to send
+            std::map<uint64_t, Reply> ready;   ///< Replies waiting for earlier ones
+            bool eof = false;          ///< Client finished sending
+            bool failed = false;
+        };
+
+        bool address(const std::string& path, sockaddr_un& addr) {
+            if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+
+        bool setNonBlocking(int fd) {
+            const int flags = fcntl(fd, F_GETFL, 0);
+            return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+
+        // Sends what the socket takes without blocking
+        void flush(Connection& c) {
+            size_t sent = 0;
+            while (sent < c.out.size()) {
+                const ssize_t w = send(c.fd, c.out.data() + sent, c.out.size() - sent, SEND_FLAGS);
+                if (w < 0 && errno == EINTR) continue;
+                if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if (w <= 0) {
+                    c.failed = true;
+                    break;
+                }
+                sent += static_cast<size_t>(w);
+            }
+            c.out.erase(0, sent);
+        }
+
+        void executor(parallel::ThreadPool& pool, Exchange& exchange, size_t maxHits,
+                      const std::atomic<bool>* stop, int notify) {
+            for (;;) {
+                std::vector<Job> batch;
+                {
+                    std::unique_lock<std::mutex> lock(exchange.mutex);
+                    exchange.wake.wait(lock, [&] { return exchange.stopping || !exchange.jobs.empty(); });
+                    if (exchange.stopping) return;
+                    batch.swap(exchange.jobs);
+                }
+
+                std::vector<Query> queries;
+                queries.reserve(batch.size());
+                for (const Job& j : batch) queries.push_back(j.query);
+                BatchStats stats;
+                const std::vector<Answer> answers = answer(pool, queries, maxHits, &stats, stop);
+                if (stop && stop->load(std::memory_order_relaxed)) return;   // Cancelled: incomplete answers
+
+                std::vector<Reply> replies;
+                replies.reserve(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    replies.push_back({batch[i].connection, batch[i].seq, format(queries[i], answers[i]),
+                                       batch[i].received, true});
+                }
+                {
+                    std::lock_guard<std::mutex> lock(exchange.mutex);
+                    for (Reply& r : replies) exchange.replies.push_back(std::move(r));
+                    ++exchange.batches;
+                    exchange.queries += batch.size();
+                    exchange.largestBatch = std::max(exchange.largestBatch, batch.size());
+                    exchange.work.passes += stats.passes;
+                    exchange.work.kSearched += stats.kSearched;
+                    exchange.work.kRequested += stats.kRequested;
+                }
+                // A full pipe already holds a pending wake-up
+                const char byte = 1;
+                while (write(notify, &byte, 1) < 0 && errno == EINTR) {}
+            }
+        }
+    }
+
+    bool available() {
+        return true;
+    }
+
+    bool serve(parallel::ThreadPool& pool, const Options& options, std::string& error) {
+        auto log = [&](const std::string& message) {
+            if (options.log) options.log(message);
+        };
+        const std::string& path = options.socketPath;
+        sockaddr_un addr;
+        if (!address(path, addr)) {
+            error = "invalid socket path: " + path;
+            return false;
+        }
+
+        // A path that accepts connections belongs to a running instance;
+        // anything else there is a stale socket from one that died
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+            close(probe);
+            error = "another instance is serving on " + path;
+            return false;
+        }
+        if (probe >= 0) close(probe);
+        unlink(path.c_str());
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listener, 128) != 0 || !setNonBlocking(listener)) {
+            error = "cannot listen on " + path + ": " + std::strerror(errno);
+            if (listener >= 0) close(listener);
+            return false;
+        }
+        int wakePipe[2];
+        if (pipe(wakePipe) != 0 || !setNonBlocking(wakePipe[0]) || !setNonBlocking(wakePipe[1])) {
+            error = std::string("cannot create the wake-up pipe: ") + std::strerror(errno);
+            close(listener);
+            unlink(path.c_str());
+            return false;
+        }
+
+        // Warm up before the first client: one full base-10 pass builds the
+        // digit tables and starts the pool's threads
+        Query warm;
+        answer(pool, {warm}, options.maxHits);
+
+        const Clock::time_point start = Clock::now();
+        Exchange exchange;
+        Meter meter(start);
+        uint64_t errors = 0;
+        // Set when the socket loop ends (stop flag or error); cancels the running batch
+        std::atomic<bool> halt{false};
+        std::thread worker(executor, std::ref(pool), std::ref(exchange), options.maxHits, &halt, wakePipe[1]);
+
+        std::map<uint64_t, Connection> connections;
+        uint64_t nextId = 0;
+        std::vector<Job> fresh;
+
+        // Queues r on its connection and sends every reply that is next in line
+        auto deliver = [&](Connection& c, Reply r) {
+            c.ready.emplace(r.seq, std::move(r));
+            const Clock::time_point now = Clock::now();
+            for (auto it = c.ready.find(c.nextReply); it != c.ready.end(); it = c.ready.find(c.nextReply)) {
+                c.out += it->second.text;
+                if (it->second.query) {
+                    meter.record(std::chrono::duration<double, std::micro>(now - it->second.received).count(), now);
+                }
+                c.ready.erase(it);
+                ++c.nextReply;
+            }
+            flush(c);
+        };
+
+        auto status = [&] {
+            const Clock::time_point now = Clock::now();
+            std::ostringstream out;
+            out.setf(std::ios::fixed);
+            out.precision(1);
+            std::lock_guard<std::mutex> lock(exchange.mutex);
+            out << "ok status uptime_s=" << std::chrono::duration<double>(now - start).count()
+                << " connections=" << connections.size()
+                << " requests=" << meter.count()
+                << " errors=" << errors
+                << " queued=" << exchange.jobs.size()
+                << " batches=" << exchange.batches
+                << " largest_batch=" << exchange.largestBatch
+                << " passes=" << exchange.work.passes
+                << " k_requested=" << exchange.work.kRequested
+                << " k_searched=" << exchange.work.kSearched
+                << " p50_us=" << meter.percentile(0.50)
+                << " p99_us=" << meter.percentile(0.99)
+                << " qps=" << meter.rate(now) << '\n';
+            return out.str();
+        };
+
+        auto handle = [&](uint64_t id, Connection& c, std::string line) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos) return;
+            const Clock::time_point received = Clock::now();
+            const uint64_t seq = c.nextSeq++;
+            Query q;
+            std::string message;
+            if (!parse(line, q, message)) {
+                ++errors;
+                deliver(c, {id, seq, "error " + message + "\n", received, false});
+            } else if (q.mode == Mode::Status) {
+                deliver(c, {id, seq, status(), received, false});
+            } else {
+                fresh.push_back({id, seq, q, received});
+            }
+        };
+
+        std::vector<pollfd> fds;
+        std::vector<uint64_t> ids;
+        while (!(options.stop && options.stop->load(std::memory_order_relaxed))) {
+            fds.assign({pollfd{listener, POLLIN, 0}, pollfd{wakePipe[0], POLLIN, 0}});
+            ids.clear();
+            for (auto& [id, c] : connections) {
+                short events = 0;
+                if (!c.eof && c.out.size() < MAX_OUTPUT) events |= POLLIN;
+                if (!c.out.empty()) events |= POLLOUT;
+                fds.push_back(pollfd{c.fd, events, 0});
+                ids.push_back(id);
+            }
+            if (poll(fds.data(), fds.size(), POLL_MS) < 0 && errno != EINTR) {
+                log(std::string("poll failed: ") + std::strerror(errno));
+                break;
+            }
+
+            if (fds[1].revents & POLLIN) {
+                char drain[64];
+                while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+                std::vector<Reply> replies;
+                {
+                    std::lock_guard<std::mutex> lock(exchange.mutex);
+                    replies.swap(exchange.replies);
+                }
+                for (Reply& r : replies) {
+                    auto it = connections.find(r.connection);
+                    if (it != connections.end()) deliver(it->second, std::move(r));
+                }
+            }
+
+            for (size_t i = 2; i < fds.size(); ++i) {
+                auto it = connections.find(ids[i - 2]);
+                if (it == connections.end()) continue;
+                Connection& c = it->second;
+                // Hung up in both directions: nobody reads the replies, and
+                // a polled hung-up socket would make every poll() return
+                if (fds[i].revents & (POLLHUP | POLLERR)) {
+                    c.failed = true;
+                    continue;
+                }
+                if (fds[i].revents & POLLIN) {
+                    char buffer[4096];
+                    for (;;) {
+                        const ssize_t r = recv(c.fd, buffer, sizeof(buffer), 0);
+                        if (r < 0 && errno == EINTR) continue;
+                        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                        if (r <= 0) {
+                            c.eof = true;
+                            break;
+                        }
+                        c.in.append(buffer, static_cast<size_t>(r));
+                    }
+                    for (size_t end; (end = c.in.find('\n')) != std::string::npos;) {
+                        std::string line = c.in.substr(0, end);
+                        c.in.erase(0, end + 1);
+                        handle(it->first, c, std::move(line));
+                    }
+                    if (c.in.size() > MAX_LINE) {
+                        ++errors;
+                        c.in.clear();
+                        c.eof = true;   // Answer what came before, then hang up
+                        deliver(c, {it->first, c.nextSeq++, "error request line too long\n", Clock::now(), false});
+                    }
+                }
+                if (fds[i].revents & POLLOUT) flush(c);
+            }
+
+            // Closed: failed, or finished sending and fully answered
+            for (auto it = connections.begin(); it != connections.end();) {
+                const Connection& c = it->second;
+                if (c.failed || (c.eof && c.nextReply == c.nextSeq && c.out.empty())) {
+                    close(c.fd);
+                    it = connections.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            if (fds[0].revents & POLLIN) {
+                for (int fd; (fd = accept(listener, nullptr, nullptr)) >= 0;) {
+                    if (!setNonBlocking(fd)) {
+                        close(fd);
+                        continue;
+                    }
+                    Connection c;
+                    c.fd = fd;
+                    connections.emplace(nextId++, std::move(c));
+                }
+            }
+
+            if (!fresh.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(exchange.mutex);
+                    for (Job& j : fresh) exchange.jobs.push_back(std::move(j));
+                }
+                fresh.clear();
+                exchange.wake.notify_one();
+            }
+        }
+
+        // The running batch stops at its next stream chunk
+        halt.store(true);
+        {
+            std::lock_guard<std::mutex> lock(exchange.mutex);
+            exchange.stopping = true;
+        }
+        exchange.wake.notify_one();
+        worker.join();
+        for (auto& [id, c] : connections) close(c.fd);
+        close(listener);
+        close(wakePipe[0]);
+        close(wakePipe[1]);
+        unlink(path.c_str());
+        return true;
+    }
+#endif
+}
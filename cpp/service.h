@@ -0,0 +1,129 @@
+/**
+ * @file service.h
+ * @brief Long-running query service on a Unix domain socket
+ *
+ * Running the binary once per query pays process startup, pool creation
+ * and table builds every time. serve() keeps all of that warm and answers
+ * queries over a Unix domain socket instead.
+ *
+ * Protocol: one request per line, answered in order per connection.
+ *   best      [base=B] [digits=D] [n=LO-HI] [k=LO-HI]
+ *   top       [count=C] [base=B] [digits=D] [n=LO-HI] [k=LO-HI]
+ *   enumerate [base=B] [digits=D] [n=LO-HI] [k=LO-HI]
+ *   status
+ * digits lists the digit set in base B (e.g. 123456789 or 0123456789AB);
+ * it has to be 1..B-1 or 0..B-1, the sets the kernels search. Defaults:
+ * base 10, digits 1..B-1, n = 2..(number of digits), k = 1..maxK, count
+ * 10; k=K and n=N select a single value. Replies:
+ *   ok best value=V k=K n=N             (V in base B; "ok best none" if no hit)
+ *   ok hits=M [truncated]               then M lines "V K N", best first
+ *   ok status requests=... p50_us=... p99_us=... qps=... ...
+ *   error <message>
+ *
+ * Batching: the socket loop queues queries and a single executor thread
+ * answers everything queued since its last batch at once, so queries that
+ * arrive while a batch runs form the next one. Within a batch, queries
+ * with the same base and digit set whose k intervals overlap or touch are
+ * answered from one pass over the union of their intervals: the pass
+ * collects every hit once (stream::collect, or the dispatched base-10
+ * enumerator for digits 1-9) and each query filters its interval and n
+ * range out of it. Status requests are answered by the socket loop and
+ * never wait for a batch.
+ *
+ * POSIX only; elsewhere available() is false and serve() fails.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "parallel.h"
+#include "stream.h"
+
+namespace impl::service {
+    enum class Mode {
+        Best,
+        Top,
+        Enumerate,
+        Status,
+    };
+
+    /**
+     * @struct Query
+     * @brief One parsed request; bounds are validated and kEnd is clamped
+     */
+    struct Query {
+        Mode mode = Mode::Best;
+        int base = 10;
+        bool zero = false;          ///< Digit set 0..B-1 instead of 1..B-1
+        int nMin = 2;
+        int nMax = 9;
+        uint64_t kBegin = 1;
+        uint64_t kEnd = 9999;       ///< Below kBegin if the interval is past maxK
+        size_t count = 10;          ///< Hits of Mode::Top
+    };
+
+    /// Parses one request line; false with a message for the client
+    bool parse(const std::string& line, Query& query, std::string& error);
+
+    /**
+     * @struct Answer
+     * @brief Hits of one query, best first (at most one for Mode::Best)
+     */
+    struct Answer {
+        std::vector<stream::Result> hits;
+        bool truncated = false;     ///< More hits than the limit
+    };
+
+    /**
+     * @struct BatchStats
+     * @brief Work of one answer() call
+     */
+    struct BatchStats {
+        uint64_t passes = 0;        ///< Shared passes over k intervals
+        uint64_t kSearched = 0;     ///< k values the passes covered
+        uint64_t kRequested = 0;    ///< Sum of the queries' k intervals
+    };
+
+    /**
+     * @brief Answers queries (no Mode::Status) with shared passes on pool
+     * @param maxHits Largest Top / Enumerate answer
+     * @param cancel Stops the passes between stream chunks once set; the
+     *               answers are incomplete then and must be discarded
+     * @return One answer per query, in order
+     */
+    std::vector<Answer> answer(parallel::ThreadPool& pool, const std::vector<Query>& queries,
+                               size_t maxHits, BatchStats* stats = nullptr,
+                               const std::atomic<bool>* cancel = nullptr);
+
+    /// Reply text of a Best, Top or Enumerate query, newline-terminated
+    std::string format(const Query& query, const Answer& answer);
+
+    /**
+     * @struct Options
+     * @brief Settings of serve()
+     */
+    struct Options {
+        std::string socketPath;
+        size_t maxHits = 100000;                   ///< Largest Top / Enumerate answer
+        const std::atomic<bool>* stop = nullptr;   ///< serve() returns once it is set
+        std::function<void(const std::string&)> log;   ///< Startup and connection errors, may be empty
+    };
+
+    /// Whether this platform supports the service
+    bool available();
+
+    /**
+     * @brief Answers requests on options.socketPath until *options.stop is set
+     *
+     * Setting *options.stop also cancels the running batch between stream
+     * chunks, so shutdown does not wait for a long pass.
+     * @param pool Workers of the shared passes (used by the executor thread only)
+     * @return false with error if the socket cannot be set up, e.g. because
+     *         another instance is serving on the path
+     */
+    bool serve(parallel::ThreadPool& pool, const Options& options, std::string& error);
+}
@@ -0,0 +1,418 @@
+/**
+ * @file shard.cpp
+ * @brief Coordinator and worker of the sharded search
+ *
+ * The coordinator is a single-threaded poll() loop over the listening
+ * socket and one connection per worker. Each connection holds at most one
+ * shard; a finished shard is answered with the next one from the queue,
+ * and a connection that fails or hangs up puts its shard back at the
+ * front. Worker processes are forked before any thread is started, so the
+ * children begin with a clean, single-threaded copy of the process.
+ */
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include "shard.h"
+#include "dispatch.h"
+#include "parallel.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <filesystem>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace impl::shard {
+    bool validate(const Job& job, std::string& error) {
+        if (job.engine == "stream") {
+            if (!stream::supported(job.base)) {
+                error = "base must be 2..16";
+                return false;
+            }
+            return true;
+        }
+        const dispatch::Engine* engine = dispatch::find(job.engine.c_str());
+        if (!engine) {
+            error = "unknown engine " + job.engine;
+        } else if (job.base != 10 || job.zero) {
+            error = "engine " + job.engine + " only searches base 10, digits 1-9";
+        } else if (!engine->supported(cpu::features())) {
+            error = "CPU does not support engine " + job.engine;
+        } else {
+            return true;
+        }
+        return false;
+    }
+
+#if defined(_WIN32)
+    bool available() {
+        return false;
+    }
+
+    Outcome coordinate(const Job&, const Options&) {
+        Outcome outcome;
+        outcome.error = "sharded runs need Unix domain sockets and fork()";
+        return outcome;
+    }
+
+    bool work(const std::string&, unsigned) {
+        return false;
+    }
+#else
+    namespace {
+        constexpr char MAGIC[8] = {'P', 'D', 'S', 'H', 'A', 'R', 'D', '1'};
+        constexpr size_t ASSIGN_BYTES = 64;
+        constexpr size_t DONE_BYTES = 48;
+        constexpr size_t ENGINE_BYTES = 24;
+        constexpr int MAX_ATTEMPTS = 3;   ///< Workers lost on one shard before the run fails
+        constexpr int POLL_MS = 100;
+
+#if defined(MSG_NOSIGNAL)
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;   // A dead peer is an error, not SIGPIPE
+#else
+        constexpr int SEND_FLAGS = 0;
+#endif
+
+        struct Assign {
+            uint64_t shard = 0;
+            uint64_t kBegin = 0;
+            uint64_t kEnd = 0;
+            int base = 10;
+            bool zero = false;
+            std::string engine;
+        };
+
+        struct Done {
+            uint64_t shard = 0;
+            uint64_t searched = 0;
+            stream::Result result;
+        };
+
+        void put(unsigned char*& p, uint64_t v, int bytes) {
+            for (int b = 0; b < bytes; ++b) *p++ = static_cast<unsigned char>(v >> (8 * b));
+        }
+
+        uint64_t get(const unsigned char*& p, int bytes) {
+            uint64_t v = 0;
+            for (int b = 0; b < bytes; ++b) v |= uint64_t{p[b]} << (8 * b);
+            p += bytes;
+            return v;
+        }
+
+        void encode(const Assign& a, unsigned char (&bytes)[ASSIGN_BYTES]) {
+            std::memset(bytes, 0, sizeof(bytes));
+            std::memcpy(bytes, MAGIC, sizeof(MAGIC));
+            unsigned char* p = bytes + sizeof(MAGIC);
+            put(p, a.shard, 8);
+            put(p, a.kBegin, 8);
+            put(p, a.kEnd, 8);
+            put(p, static_cast<uint64_t>(a.base), 4);
+            put(p, a.zero ? 1 : 0, 4);
+            std::memcpy(p, a.engine.data(), std::min(a.engine.size(), ENGINE_BYTES - 1));
+        }
+
+        bool decode(const unsigned char (&bytes)[ASSIGN_BYTES], Assign& a) {
+            if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) return false;
+            const unsigned char* p = bytes + sizeof(MAGIC);
+            a.shard = get(p, 8);
+            a.kBegin = get(p, 8);
+            a.kEnd = get(p, 8);
+            a.base = static_cast<int>(get(p, 4));
+            a.zero = get(p, 4) != 0;
+            const char* name = reinterpret_cast<const char*>(p);
+            a.engine.assign(name, strnlen(name, ENGINE_BYTES));
+            return true;
+        }
+
+        void encode(const Done& d, unsigned char (&bytes)[DONE_BYTES]) {
+            std::memset(bytes, 0, sizeof(bytes));
+            std::memcpy(bytes, MAGIC, sizeof(MAGIC));
+            unsigned char* p = bytes + sizeof(MAGIC);
+            put(p, d.shard, 8);
+            put(p, d.searched, 8);
+            put(p, d.result.maxVal, 8);
+            put(p, d.result.bestK, 8);
+            put(p, static_cast<uint64_t>(d.result.bestN), 4);
+        }
+
+        bool decode(const unsigned char (&bytes)[DONE_BYTES], Done& d) {
+            if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) return false;
+            const unsigned char* p = bytes + sizeof(MAGIC);
+            d.shard = get(p, 8);
+            d.searched = get(p, 8);
+            d.result.maxVal = get(p, 8);
+            d.result.bestK = get(p, 8);
+            d.result.bestN = static_cast<int>(get(p, 4));
+            return true;
+        }
+
+        bool sendAll(int fd, const unsigned char* p, size_t n) {
+            while (n > 0) {
+                ssize_t w = send(fd, p, n, SEND_FLAGS);
+                if (w < 0 && errno == EINTR) continue;
+                if (w <= 0) return false;
+                p += w;
+                n -= static_cast<size_t>(w);
+            }
+            return true;
+        }
+
+        // False on EOF or error
+        bool recvAll(int fd, unsigned char* p, size_t n) {
+            while (n > 0) {
+                ssize_t r = recv(fd, p, n, 0);
+                if (r < 0 && errno == EINTR) continue;
+                if (r <= 0) return false;
+                p += r;
+                n -= static_cast<size_t>(r);
+            }
+            return true;
+        }
+
+        bool address(const std::string& path, sockaddr_un& addr) {
+            if (path.size() >= sizeof(addr.sun_path)) return false;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+
+        // Searches one shard in this process
+        bool search(const Assign& a, parallel::ThreadPool& pool, Done& done) {
+            done.shard = a.shard;
+            if (a.engine == "stream") {
+                stream::Outcome o = stream::search(pool, a.base, a.zero, a.kBegin, a.kEnd);
+                done.result = o.result;
+                done.searched = o.total;
+                return true;
+            }
+            const dispatch::Engine* engine = dispatch::find(a.engine.c_str());
+            if (!engine || !engine->supported(cpu::features())) return false;
+            const int lo = static_cast<int>(std::min<uint64_t>(a.kBegin, INT_MAX));
+            const int hi = static_cast<int>(std::min<uint64_t>(a.kEnd, INT_MAX));
+            CalcResult r = parallel::calc(pool, engine->calcRange, lo, hi);
+            done.result = {r.maxVal, static_cast<uint64_t>(r.bestK), r.bestN};
+            done.searched = a.kEnd - a.kBegin + 1;
+            return true;
+        }
+    }
+
+    bool available() {
+        return true;
+    }
+
+    bool work(const std::string& socketPath, unsigned threads) {
+        sockaddr_un addr;
+        if (!address(socketPath, addr)) return false;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            return false;
+        }
+
+        parallel::ThreadPool pool(threads);
+        bool ok = true;
+        unsigned char in[ASSIGN_BYTES];
+        unsigned char out[DONE_BYTES];
+        while (recvAll(fd, in, sizeof(in))) {   // The coordinator hangs up when it is done
+            Assign a;
+            Done d;
+            if (!decode(in, a) || !search(a, pool, d)) {
+                ok = false;
+                break;
+            }
+            encode(d, out);
+            if (!sendAll(fd, out, sizeof(out))) {
+                ok = false;
+                break;
+            }
+        }
+        close(fd);
+        return ok;
+    }
+
+    Outcome coordinate(const Job& job, const Options& options) {
+        Outcome outcome;
+        const auto start = std::chrono::steady_clock::now();
+        auto log = [&](const std::string& message) {
+            if (options.log) options.log(message);
+        };
+        if (!validate(job, outcome.error)) return outcome;
+
+        const uint64_t kBegin = std::max<uint64_t>(job.kBegin, 1);
+        const uint64_t kEnd = std::min(job.kEnd, stream::maxK(job.base, job.zero));
+        if (kEnd < kBegin) return outcome;
+
+        const unsigned processes = std::max(options.processes, 1u);
+        const uint64_t total = kEnd - kBegin + 1;
+        const uint64_t wanted = options.shards ? options.shards : uint64_t{8} * processes;
+        const uint64_t shardSize = (total - 1) / std::min(wanted, total) + 1;
+        outcome.shards = (total - 1) / shardSize + 1;
+
+        std::string path = options.socketPath;
+        if (path.empty()) {
+            std::error_code ec;
+            path = (std::filesystem::temp_directory_path(ec) /
+                    ("pandigital-" + std::to_string(getpid()) + ".sock")).string();
+        }
+        sockaddr_un addr;
+        if (!address(path, addr)) {
+            outcome.error = "socket path too long: " + path;
+            return outcome;
+        }
+        unlink(path.c_str());
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listener, 64) != 0) {
+            outcome.error = "cannot listen on " + path + ": " + std::strerror(errno);
+            if (listener >= 0) close(listener);
+            return outcome;
+        }
+
+        struct Connection {
+            int fd;
+            uint64_t shard;
+            bool busy;
+        };
+        std::vector<Connection> connections;
+        std::vector<pid_t> children;
+
+        auto spawn = [&] {
+            pid_t pid = fork();
+            if (pid == 0) {
+                // The child only needs its own connection
+                close(listener);
+                for (const auto& c : connections) close(c.fd);
+                _exit(work(path, options.threads) ? 0 : 1);
+            }
+            if (pid > 0) children.push_back(pid);
+            return pid > 0;
+        };
+
+        std::deque<uint64_t> queue;
+        for (uint64_t s = 0; s < outcome.shards; ++s) queue.push_back(s);
+        std::vector<uint8_t> finished(outcome.shards, 0);
+        std::vector<int> attempts(outcome.shards, 0);
+        uint64_t remaining = outcome.shards;
+
+        // Hands c the next shard; false if c has to be dropped
+        auto assign = [&](Connection& c) {
+            if (queue.empty()) return false;
+            const uint64_t s = queue.front();
+            queue.pop_front();
+            Assign a;
+            a.shard = s;
+            a.kBegin = kBegin + s * shardSize;
+            a.kEnd = a.kBegin + std::min(shardSize - 1, kEnd - a.kBegin);
+            a.base = job.base;
+            a.zero = job.zero;
+            a.engine = job.engine;
+            unsigned char bytes[ASSIGN_BYTES];
+            encode(a, bytes);
+            c.shard = s;
+            c.busy = true;
+            if (sendAll(c.fd, bytes, sizeof(bytes))) return true;
+            queue.push_front(s);
+            c.busy = false;
+            return false;
+        };
+
+        // Closes c and requeues its shard
+        auto drop = [&](Connection& c) {
+            close(c.fd);
+            c.fd = -1;
+            if (!c.busy || finished[c.shard]) return;
+            if (++attempts[c.shard] >= MAX_ATTEMPTS) {
+                outcome.error = "shard " + std::to_string(c.shard) + " lost " +
+                                std::to_string(MAX_ATTEMPTS) + " workers";
+                return;
+            }
+            queue.push_front(c.shard);
+            ++outcome.reassigned;
+            log("worker lost, shard " + std::to_string(c.shard) + " requeued");
+        };
+
+        std::fflush(nullptr);   // Children must not inherit unflushed output
+        for (unsigned i = 0; i < processes; ++i) spawn();
+
+        std::vector<pollfd> fds;
+        while (remaining > 0 && outcome.error.empty()) {
+            fds.assign(1, pollfd{listener, POLLIN, 0});
+            for (const auto& c : connections) fds.push_back(pollfd{c.fd, POLLIN, 0});
+            if (poll(fds.data(), fds.size(), POLL_MS) < 0 && errno != EINTR) {
+                outcome.error = std::string("poll failed: ") + std::strerror(errno);
+                break;
+            }
+
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+                Connection& c = connections[i - 1];
+                unsigned char bytes[DONE_BYTES];
+                Done d;
+                if (!recvAll(c.fd, bytes, sizeof(bytes)) || !decode(bytes, d) || !c.busy || d.shard != c.shard) {
+                    drop(c);
+                    continue;
+                }
+                c.busy = false;
+                if (!finished[d.shard]) {
+                    finished[d.shard] = 1;
+                    --remaining;
+                    stream::merge(outcome.result, d.result);
+                    outcome.searched += d.searched;
+                }
+                if (!assign(c)) drop(c);
+            }
+            connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                             [](const Connection& c) { return c.fd < 0; }),
+                              connections.end());
+
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0) {
+                    connections.push_back({fd, 0, false});
+                    if (!assign(connections.back())) {
+                        close(fd);   // Nothing left to hand out
+                        connections.pop_back();
+                    }
+                }
+            }
+
+            // Reap exited workers (only ours, not other children of the
+            // embedding process) and replace them while shards wait
+            children.erase(std::remove_if(children.begin(), children.end(),
+                                          [](pid_t pid) { return waitpid(pid, nullptr, WNOHANG) == pid; }),
+                           children.end());
+            while (!queue.empty() && children.size() < processes && outcome.respawned < options.maxRespawns) {
+                if (!spawn()) break;
+                ++outcome.respawned;
+                log("forked a replacement worker");
+            }
+            if (!queue.empty() && connections.empty() && children.empty()) {
+                outcome.error = "all workers lost";
+            }
+        }
+
+        // Hanging up tells every idle worker to exit; after an error the
+        // others may be in the middle of a shard and would only notice the
+        // hang-up once it is done, so they are terminated
+        for (const auto& c : connections) close(c.fd);
+        close(listener);
+        unlink(path.c_str());
+        if (!outcome.error.empty()) {
+            for (pid_t pid : children) kill(pid, SIGTERM);
+        }
+        for (pid_t pid : children) waitpid(pid, nullptr, 0);
+        outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return outcome;
+    }
+#endif
+}
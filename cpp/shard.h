@@ -0,0 +1,91 @@
+/**
+ * @file shard.h
+ * @brief Multi-process sharded search with a local coordinator
+ *
+ * The coordinator cuts [kBegin, kEnd] into shards and hands them out over
+ * a Unix domain socket. Workers are separate processes: the coordinator
+ * forks `processes` of them, and more can join from outside with the
+ * socket path (e.g. one per NUMA node under numactl). Each worker receives
+ * a shard together with the job (engine, base, mode), searches it and
+ * sends back the Result, then gets the next shard.
+ *
+ * A worker that disconnects or dies loses its shard to the queue, and a
+ * replacement process is forked while work remains. Results are merged
+ * with stream::merge, whose total order makes the answer independent of
+ * which process searched which shard.
+ *
+ * Messages are fixed-size and little-endian:
+ *   Assign (64 bytes): magic "PDSHARD1", u64 shard, u64 kBegin, u64 kEnd,
+ *                      u32 base, u32 zero, char engine[24]
+ *   Done   (48 bytes): magic "PDSHARD1", u64 shard, u64 searched,
+ *                      u64 maxVal, u64 bestK, u32 bestN, u32 reserved
+ * The coordinator closes the connection when no shards are left.
+ *
+ * POSIX only; elsewhere available() is false and both calls fail.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "stream.h"
+
+namespace impl::shard {
+    /**
+     * @struct Job
+     * @brief What every shard of one run searches
+     *
+     * engine is "stream" (any base and mode) or a dispatch table id such
+     * as "avx2" or "simple" (base 10, digits 1-9 only).
+     */
+    struct Job {
+        std::string engine = "stream";
+        int base = 10;
+        bool zero = false;
+        uint64_t kBegin = 1;
+        uint64_t kEnd = UINT64_MAX;   ///< Clamped to the base's limit
+    };
+
+    /// Checks the engine id and its base/mode restrictions
+    bool validate(const Job& job, std::string& error);
+
+    /**
+     * @struct Options
+     * @brief Coordinator settings
+     */
+    struct Options {
+        unsigned processes = 2;         ///< Worker processes to fork
+        uint64_t shards = 0;            ///< Number of shards, 0 for 8 per process
+        std::string socketPath;         ///< Empty for a private path in the temp directory
+        unsigned threads = 1;           ///< Threads per forked worker
+        unsigned maxRespawns = 16;      ///< Replacement workers before giving up
+        std::function<void(const std::string&)> log;   ///< Events (lost workers etc.), may be empty
+    };
+
+    /**
+     * @struct Outcome
+     * @brief Result of coordinate()
+     */
+    struct Outcome {
+        stream::Result result;
+        uint64_t searched = 0;      ///< k values in finished shards
+        uint64_t shards = 0;
+        uint64_t reassigned = 0;    ///< Shards handed out again after a worker was lost
+        unsigned respawned = 0;     ///< Replacement processes forked
+        std::string error;          ///< Non-empty if the run failed
+        double seconds = 0;
+    };
+
+    /// Whether this platform supports sharded runs
+    bool available();
+
+    /// Runs job on forked worker processes and returns the merged result
+    Outcome coordinate(const Job& job, const Options& options);
+
+    /**
+     * @brief Serves shards from the coordinator at socketPath until it hangs up
+     * @return false if the coordinator cannot be reached or sends garbage
+     */
+    bool work(const std::string& socketPath, unsigned threads = 1);
+}
@@ -0,0 +1,193 @@
+/**
+ * @file simd_best.h
+ * @brief Register-resident running maximum for the range kernels
+ *
+ * A range kernel keeps, per lane, the best (value, k, n) seen so far in
+ * three vector registers and updates them with a compare + blend after
+ * every batch: no store, no branch and no scalar loop per batch. Each
+ * lane sees its k values in ascending order, so a strict compare keeps
+ * the smallest k of equal values, and the single reduction at the end of
+ * the range folds the lanes with mergeMax.
+ *
+ * k vectors are generated in registers (kBegin + iota, then + step per
+ * batch); lanes past kEnd are masked out with one compare instead of
+ * being padded through a scalar-filled array. The radix kernels carry
+ * 64-bit concatenations and use the Best8x64 / Best16x64 variants.
+ *
+ * Like simd_divide.h, the helpers sit in an unnamed namespace because the
+ * header is included by translation units built with different -m flags.
+ */
+
+#pragma once
+
+#include <immintrin.h>
+#include "calc_result.h"
+
+namespace impl::simd {
+    namespace {
+#if defined(__AVX2__)
+        /**
+         * @struct Best8
+         * @brief Per-lane best hit of 8 32-bit lanes
+         */
+        struct Best8 {
+            __m256i value = _mm256_setzero_si256();
+            __m256i k = _mm256_setzero_si256();
+            __m256i n = _mm256_setzero_si256();
+        };
+
+        /// k, k+1, ..., k+7
+        inline __m256i kLanes8(int k) {
+            return _mm256_add_epi32(_mm256_set1_epi32(k), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        }
+
+        /// All-ones in lanes with k <= kEnd
+        inline __m256i inRange8(__m256i kVec, int kEnd) {
+            return _mm256_cmpgt_epi32(_mm256_set1_epi32(kEnd + 1), kVec);
+        }
+
+        /// Lanes in valid (all-ones) that beat their best take value, k and n
+        inline void update(Best8& best, __m256i valid, __m256i value, __m256i k, __m256i n) {
+            __m256i better = _mm256_and_si256(valid, _mm256_cmpgt_epi32(value, best.value));
+            best.value = _mm256_blendv_epi8(best.value, value, better);
+            best.k = _mm256_blendv_epi8(best.k, k, better);
+            best.n = _mm256_blendv_epi8(best.n, n, better);
+        }
+
+        /// Folds the lanes of best into result; once per range
+        inline void reduce(const Best8& best, CalcResult& result) {
+            alignas(32) int value[8], k[8], n[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(value), best.value);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(k), best.k);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(n), best.n);
+            for (int i = 0; i < 8; ++i) {
+                mergeMax(result, {static_cast<uint64_t>(value[i]), k[i], n[i]});
+            }
+        }
+
+        /**
+         * @struct Best8x64
+         * @brief Per-lane best hit of 8 lanes with 64-bit values
+         *
+         * The value is split like the radix kernels' concatenation: lanes
+         * 0-3 in valueLo, lanes 4-7 in valueHi. Values stay below 2^63, so
+         * the signed 64-bit compare is exact.
+         */
+        struct Best8x64 {
+            __m256i valueLo = _mm256_setzero_si256();
+            __m256i valueHi = _mm256_setzero_si256();
+            __m256i k = _mm256_setzero_si256();
+            __m256i n = _mm256_setzero_si256();
+        };
+
+        /// Lanes in valid (all-ones 32-bit lanes) that beat their best take value, k and n
+        inline void update(Best8x64& best, __m256i valid, __m256i valueLo, __m256i valueHi, __m256i k, __m256i n) {
+            __m256i betterLo = _mm256_and_si256(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(valid)),
+                                                _mm256_cmpgt_epi64(valueLo, best.valueLo));
+            __m256i betterHi = _mm256_and_si256(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(valid, 1)),
+                                                _mm256_cmpgt_epi64(valueHi, best.valueHi));
+            best.valueLo = _mm256_blendv_epi8(best.valueLo, valueLo, betterLo);
+            best.valueHi = _mm256_blendv_epi8(best.valueHi, valueHi, betterHi);
+
+            // Even dwords of both masks, back in lane order 0..7
+            __m256i better = _mm256_castps_si256(_mm256_shuffle_ps(
+                _mm256_castsi256_ps(betterLo), _mm256_castsi256_ps(betterHi), _MM_SHUFFLE(2, 0, 2, 0)));
+            better = _mm256_permute4x64_epi64(better, _MM_SHUFFLE(3, 1, 2, 0));
+            best.k = _mm256_blendv_epi8(best.k, k, better);
+            best.n = _mm256_blendv_epi8(best.n, n, better);
+        }
+
+        /// Folds the lanes of best into result; once per range
+        inline void reduce(const Best8x64& best, CalcResult& result) {
+            alignas(32) uint64_t value[8];
+            alignas(32) int k[8], n[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(value), best.valueLo);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(value + 4), best.valueHi);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(k), best.k);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(n), best.n);
+            for (int i = 0; i < 8; ++i) {
+                mergeMax(result, {value[i], k[i], n[i]});
+            }
+        }
+#endif
+
+#if defined(__AVX512F__)
+        /**
+         * @struct Best16
+         * @brief Per-lane best hit of 16 32-bit lanes
+         */
+        struct Best16 {
+            __m512i value = _mm512_setzero_si512();
+            __m512i k = _mm512_setzero_si512();
+            __m512i n = _mm512_setzero_si512();
+        };
+
+        /// k, k+1, ..., k+15
+        inline __m512i kLanes16(int k) {
+            return _mm512_add_epi32(_mm512_set1_epi32(k),
+                _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        }
+
+        /// Lanes with k <= kEnd
+        inline __mmask16 inRange16(__m512i kVec, int kEnd) {
+            return _mm512_cmp_epi32_mask(kVec, _mm512_set1_epi32(kEnd), _MM_CMPINT_LE);
+        }
+
+        /// Lanes in valid that beat their best take value, k and n
+        inline void update(Best16& best, __mmask16 valid, __m512i value, __m512i k, __m512i n) {
+            __mmask16 better = _mm512_mask_cmp_epi32_mask(valid, value, best.value, _MM_CMPINT_GT);
+            best.value = _mm512_mask_mov_epi32(best.value, better, value);
+            best.k = _mm512_mask_mov_epi32(best.k, better, k);
+            best.n = _mm512_mask_mov_epi32(best.n, better, n);
+        }
+
+        /// Folds the lanes of best into result; once per range
+        inline void reduce(const Best16& best, CalcResult& result) {
+            alignas(64) int value[16], k[16], n[16];
+            _mm512_store_si512(value, best.value);
+            _mm512_store_si512(k, best.k);
+            _mm512_store_si512(n, best.n);
+            for (int i = 0; i < 16; ++i) {
+                mergeMax(result, {static_cast<uint64_t>(value[i]), k[i], n[i]});
+            }
+        }
+
+        /**
+         * @struct Best16x64
+         * @brief Per-lane best hit of 16 lanes with 64-bit values (lanes 0-7 in valueLo, 8-15 in valueHi)
+         */
+        struct Best16x64 {
+            __m512i valueLo = _mm512_setzero_si512();
+            __m512i valueHi = _mm512_setzero_si512();
+            __m512i k = _mm512_setzero_si512();
+            __m512i n = _mm512_setzero_si512();
+        };
+
+        /// Lanes in valid that beat their best take value, k and n
+        inline void update(Best16x64& best, __mmask16 valid, __m512i valueLo, __m512i valueHi, __m512i k, __m512i n) {
+            __mmask8 betterLo = _mm512_mask_cmp_epu64_mask(static_cast<__mmask8>(valid), valueLo, best.valueLo,
+                                                           _MM_CMPINT_NLE);
+            __mmask8 betterHi = _mm512_mask_cmp_epu64_mask(static_cast<__mmask8>(valid >> 8), valueHi, best.valueHi,
+                                                           _MM_CMPINT_NLE);
+            __mmask16 better = static_cast<__mmask16>(betterLo | (betterHi << 8));
+            best.valueLo = _mm512_mask_mov_epi64(best.valueLo, betterLo, valueLo);
+            best.valueHi = _mm512_mask_mov_epi64(best.valueHi, betterHi, valueHi);
+            best.k = _mm512_mask_mov_epi32(best.k, better, k);
+            best.n = _mm512_mask_mov_epi32(best.n, better, n);
+        }
+
+        /// Folds the lanes of best into result; once per range
+        inline void reduce(const Best16x64& best, CalcResult& result) {
+            alignas(64) uint64_t value[16];
+            alignas(64) int k[16], n[16];
+            _mm512_store_si512(value, best.valueLo);
+            _mm512_store_si512(value + 8, best.valueHi);
+            _mm512_store_si512(k, best.k);
+            _mm512_store_si512(n, best.n);
+            for (int i = 0; i < 16; ++i) {
+                mergeMax(result, {value[i], k[i], n[i]});
+            }
+        }
+#endif
+    }
+}
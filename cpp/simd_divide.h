@@ -0,0 +1,108 @@
+/**
+ * @file simd_divide.h
+ * @brief Vector unsigned division by compile-time constants
+ *
+ * x / D is computed as (x * M) >> (32 + S) with a 32-bit magic multiplier
+ * M = ceil(2^(32+S) / D). _mm256_mul_epu32 / _mm512_mul_epu32 produce the
+ * full 64-bit products of the even lanes; odd lanes are shifted down first
+ * and blended back. This replaces the SVML _mm256_div_epi32, which GCC and
+ * Clang do not provide and MSVC/ICC lower to a library call.
+ *
+ * The functions sit in an unnamed namespace on purpose: this header is
+ * included by translation units built with different -m flags, and a
+ * shared (linker-merged) instantiation could pick up AVX-512 encodings
+ * inside the AVX2 kernels.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace impl::simd {
+    /**
+     * @struct DivMagic
+     * @brief Multiplier and shift for exact x / D over x < 2^Bits
+     *
+     * With M = ceil(2^p / D) and e = M*D - 2^p, the quotient is exact for
+     * every x < 2^Bits whenever e <= 2^(p - Bits). The smallest shift that
+     * satisfies this with a 32-bit M is chosen at compile time.
+     */
+    template <uint32_t D, unsigned Bits = 32>
+    struct DivMagic {
+        static_assert(D >= 2, "divisor must be at least 2");
+        static_assert(Bits >= 1 && Bits <= 32, "dividend width must be 1..32 bits");
+
+    private:
+        struct Params { uint32_t multiplier; unsigned shift; bool ok; };
+
+        static constexpr Params find() {
+            for (unsigned s = 0; s < 32; ++s) {
+                const unsigned p = 32 + s;
+                const uint64_t pow = uint64_t{1} << p;
+                const uint64_t m = (pow + D - 1) / D;
+                if (m > 0xFFFFFFFFull) continue;
+                const uint64_t err = m * D - pow;
+                if (err <= (uint64_t{1} << (p - Bits))) {
+                    return {static_cast<uint32_t>(m), s, true};
+                }
+            }
+            return {0, 0, false};
+        }
+
+        static constexpr Params params = find();
+        static_assert(params.ok, "no 32-bit magic multiplier for this divisor and width");
+
+    public:
+        static constexpr uint32_t multiplier = params.multiplier;
+        static constexpr unsigned shift = params.shift;   ///< Extra shift beyond 32
+    };
+
+    namespace {
+#if defined(__AVX2__)
+        /// Unsigned x / D for each 32-bit lane (exact for lanes below 2^Bits)
+        template <uint32_t D, unsigned Bits = 32>
+        inline __m256i div_epu32(__m256i x) {
+            using Magic = DivMagic<D, Bits>;
+            const __m256i m = _mm256_set1_epi32(static_cast<int>(Magic::multiplier));
+            // Even lanes: quotient lands in the low dword after >> (32 + S)
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, m), 32 + Magic::shift);
+            // Odd lanes: after >> S the quotient is already in the high dword
+            __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), m), Magic::shift);
+            return _mm256_blend_epi32(even, odd, 0xAA);
+        }
+
+        /// Unsigned x % D for each 32-bit lane, given q = x / D
+        template <uint32_t D>
+        inline __m256i rem_epu32(__m256i x, __m256i q) {
+            return _mm256_sub_epi32(x, _mm256_mullo_epi32(q, _mm256_set1_epi32(static_cast<int>(D))));
+        }
+
+        inline __m256i div10_epu32(__m256i x) { return div_epu32<10>(x); }
+        inline __m256i div100_epu32(__m256i x) { return div_epu32<100>(x); }
+        inline __m256i div10000_epu32(__m256i x) { return div_epu32<10000>(x); }
+#endif
+
+#if defined(__AVX512F__)
+        /// Unsigned x / D for each 32-bit lane (exact for lanes below 2^Bits)
+        template <uint32_t D, unsigned Bits = 32>
+        inline __m512i div_epu32(__m512i x) {
+            using Magic = DivMagic<D, Bits>;
+            const __m512i m = _mm512_set1_epi32(static_cast<int>(Magic::multiplier));
+            __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(x, m), 32 + Magic::shift);
+            __m512i odd = _mm512_srli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(x, 32), m), Magic::shift);
+            return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+        }
+
+        /// Unsigned x % D for each 32-bit lane, given q = x / D
+        template <uint32_t D>
+        inline __m512i rem_epu32(__m512i x, __m512i q) {
+            return _mm512_sub_epi32(x, _mm512_mullo_epi32(q, _mm512_set1_epi32(static_cast<int>(D))));
+        }
+
+        inline __m512i div10_epu32(__m512i x) { return div_epu32<10>(x); }
+        inline __m512i div100_epu32(__m512i x) { return div_epu32<100>(x); }
+        inline __m512i div10000_epu32(__m512i x) { return div_epu32<10000>(x); }
+#endif
+    }
+}
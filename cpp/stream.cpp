@@ -0,0 +1,166 @@
+/**
+ * @file stream.cpp
+ * @brief Chunked driver of the streaming search
+ *
+ * Runs the scalar kernel on every host: an AVX2 variant that vectorized
+ * only k*n and then ran the same per-lane digit loop was slower than it
+ * (no early exit, an extra store and reload per product), so it was
+ * dropped. Work distribution follows
+ * parallel::calc: chunks are claimed with an atomic counter. Workers record
+ * finished chunks in a checkpoint::State and stop claiming once the cancel
+ * flag is set; worker 0 (the calling thread) reports progress and writes
+ * the checkpoint.
+ */
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include "stream.h"
+#include "checkpoint.h"
+
+namespace impl::stream {
+    namespace {
+        double since(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    uint64_t maxK(int base, bool zero) {
+        if (!supported(base)) return 0;
+        const int digits = zero ? base : base - 1;
+        return radix::ipow(base, digits / 2) - 1;
+    }
+
+    const char* kernelName() {
+        return "Scalar";
+    }
+
+    Outcome search(parallel::ThreadPool& pool, int base, bool zero,
+                   uint64_t kBegin, uint64_t kEnd, const Options& options) {
+        Outcome outcome;
+        kBegin = std::max<uint64_t>(kBegin, 1);
+        kEnd = std::min(kEnd, maxK(base, zero));
+        if (kEnd < kBegin) return outcome;
+
+        const uint64_t chunk = std::max<uint64_t>(options.chunk, 1);
+        outcome.total = kEnd - kBegin + 1;
+        const uint64_t chunks = (outcome.total - 1) / chunk + 1;
+
+        // Finished chunks and the best hit; hits are rare and a chunk takes
+        // about a millisecond, so one lock per chunk is negligible
+        std::mutex stateMutex;
+        checkpoint::State state;
+        state.params = checkpoint::hash(base, zero, kBegin, kEnd, chunk);
+        if (options.checkpoint) {
+            switch (checkpoint::load(options.checkpoint, state.params, state)) {
+                case checkpoint::Load::Corrupt:
+                    outcome.error = "checkpoint file is damaged";
+                    return outcome;
+                case checkpoint::Load::Mismatch:
+                    outcome.error = "checkpoint file belongs to a different search";
+                    return outcome;
+                default:
+                    break;
+            }
+            outcome.resumed = state.searched;
+        }
+        // Workers only read the resumed chunks; chunks of this run are
+        // never claimed twice
+        const checkpoint::State resumed = state;
+
+        std::atomic<uint64_t> next{state.watermark};
+        std::atomic<bool> stopped{false};
+        const auto start = std::chrono::steady_clock::now();
+
+        auto snapshot = [&] {
+            Progress p;
+            p.total = outcome.total;
+            p.resumed = outcome.resumed;
+            p.seconds = since(start);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            p.done = state.searched;
+            p.best = state.best;
+            return p;
+        };
+
+        auto save = [&] {
+            checkpoint::State copy;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                copy = state;
+            }
+            if (!checkpoint::save(options.checkpoint, copy)) outcome.checkpointFailed = true;
+        };
+
+        pool.run([&](unsigned worker) {
+            double nextReport = options.interval;
+            double nextSave = options.checkpointInterval;
+            for (;;) {
+                if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                const uint64_t c = next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks) break;
+                if (resumed.done(c)) continue;
+
+                const uint64_t lo = kBegin + c * chunk;
+                const uint64_t hi = lo + std::min(chunk - 1, kEnd - lo);
+                const Result r = scalar::calc(base, zero, lo, hi);
+                {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    merge(state.best, r);
+                    state.searched += hi - lo + 1;
+                    state.finish(c);
+                    if (options.onChunk) options.onChunk(lo, hi, r);
+                }
+
+                if (worker != 0) continue;
+                const double now = since(start);
+                if (options.progress && now >= nextReport) {
+                    options.progress(snapshot());
+                    nextReport = now + options.interval;
+                }
+                if (options.checkpoint && now >= nextSave) {
+                    save();
+                    nextSave = since(start) + options.checkpointInterval;
+                }
+            }
+        });
+
+        outcome.result = state.best;
+        outcome.searched = state.searched;
+        outcome.cancelled = stopped.load() && outcome.searched < outcome.total;
+        outcome.seconds = since(start);
+        if (options.checkpoint) save();
+        if (options.progress) options.progress(snapshot());
+        return outcome;
+    }
+
+    std::vector<Result> collect(parallel::ThreadPool& pool, int base, bool zero,
+                                uint64_t kBegin, uint64_t kEnd, uint64_t chunk,
+                                const std::atomic<bool>* cancel) {
+        std::vector<Result> all;
+        kBegin = std::max<uint64_t>(kBegin, 1);
+        kEnd = std::min(kEnd, maxK(base, zero));
+        if (kEnd < kBegin) return all;
+
+        chunk = std::max<uint64_t>(chunk, 1);
+        const uint64_t chunks = (kEnd - kBegin) / chunk + 1;
+        std::atomic<uint64_t> next{0};
+        std::mutex allMutex;
+
+        pool.run([&](unsigned) {
+            std::vector<Result> local;
+            const HitFn keep = [&local](const Result& hit) { local.push_back(hit); };
+            for (uint64_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+                if (cancel && cancel->load(std::memory_order_relaxed)) break;
+                const uint64_t lo = kBegin + c * chunk;
+                scalar::enumerate(base, zero, lo, lo + std::min(chunk - 1, kEnd - lo), keep);
+            }
+            std::lock_guard<std::mutex> lock(allMutex);
+            all.insert(all.end(), local.begin(), local.end());
+        });
+        std::sort(all.begin(), all.end(), greater);
+        return all;
+    }
+}
@@ -0,0 +1,177 @@
+/**
+ * @file stream.h
+ * @brief Streaming base-b search over 64-bit k ranges
+ *
+ * The fixed-range engines use int k and 32-bit products, which is exact
+ * for base 10 (k <= 9999) and for the radix kernels up to their K_LIMIT,
+ * but silently wraps once the search space grows: base 16 in zero mode
+ * already needs k up to 16^8 = 2^32. This engine keeps k, the products
+ * and the concatenation in 64-bit arithmetic, so any base 2..16 works in
+ * both modes.
+ *
+ * search() cuts [kBegin, kEnd] into fixed-size chunks claimed from an
+ * atomic counter, like parallel::calc, so memory stays flat whatever the
+ * range size. Between chunks it checks a cancel flag and, on the calling
+ * thread, reports progress at a fixed interval. collect() runs the same
+ * kernels over the same chunks but keeps every hit, not just the best.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "parallel.h"
+#include "radix.h"
+
+namespace impl::stream {
+    /**
+     * @struct Result
+     * @brief CalcResult with a 64-bit k
+     */
+    struct Result {
+        uint64_t maxVal = 0;   ///< Largest pandigital found, 0 if none
+        uint64_t bestK = 0;    ///< k producing maxVal
+        int bestN = 0;         ///< n producing maxVal
+    };
+
+    /// Same total order as mergeMax: larger value, then smaller k, then smaller n
+    inline void merge(Result& best, const Result& candidate) {
+        if (candidate.maxVal > best.maxVal ||
+            (candidate.maxVal == best.maxVal && candidate.maxVal != 0 &&
+             (candidate.bestK < best.bestK ||
+              (candidate.bestK == best.bestK && candidate.bestN < best.bestN)))) {
+            best = candidate;
+        }
+    }
+
+    /// Orders hits like merge: true if a ranks before b
+    inline bool greater(const Result& a, const Result& b) {
+        if (a.maxVal != b.maxVal) return a.maxVal > b.maxVal;
+        if (a.bestK != b.bestK) return a.bestK < b.bestK;
+        return a.bestN < b.bestN;
+    }
+
+    /// Receives one hit (value, k, n) of an enumeration
+    using HitFn = std::function<void(const Result& hit)>;
+
+    /**
+     * @struct Space
+     * @brief Compile-time constants of the base-Base search in 64-bit lanes
+     *
+     * Like radix::Radix, without the 32-bit product limit: k < K_LIMIT
+     * keeps k*1 || k*2 within DIGITS digits, and DIGITS <= 16 base-16
+     * digits keep the concatenation within 64 bits.
+     */
+    template <int Base, bool Zero>
+    struct Space {
+        static_assert(Base >= 2 && Base <= 16, "base must be 2..16");
+
+        static constexpr int DIGITS = Zero ? Base : Base - 1;
+        static constexpr uint32_t FULL_MASK = ((1u << Base) - 1) & (Zero ? ~0u : ~1u);
+        static constexpr int MAX_N = DIGITS;
+        static constexpr uint64_t K_LIMIT = radix::ipow(Base, DIGITS / 2);
+    };
+
+    /**
+     * @struct Progress
+     * @brief Snapshot passed to the progress callback
+     */
+    struct Progress {
+        uint64_t done = 0;      ///< k values searched so far
+        uint64_t total = 0;     ///< k values in the (clamped) range
+        uint64_t resumed = 0;   ///< Part of done taken from a checkpoint
+        double seconds = 0;     ///< Time since the search started
+        Result best;            ///< Best hit of the chunks finished so far
+
+        /// k values per second searched by this run
+        double rate() const { return seconds > 0 ? (done - resumed) / seconds : 0.0; }
+    };
+
+    using ProgressFn = std::function<void(const Progress&)>;
+
+    /// 64K k values per chunk: small enough for fast cancellation, large
+    /// enough that claiming a chunk costs nothing next to searching it
+    constexpr uint64_t DEFAULT_CHUNK = uint64_t{1} << 16;
+
+    /**
+     * @struct Options
+     * @brief Chunking, progress and cancellation of one search
+     */
+    struct Options {
+        uint64_t chunk = DEFAULT_CHUNK;          ///< k values claimed per step
+        double interval = 1.0;                   ///< Seconds between progress calls
+        ProgressFn progress;                     ///< Called on the calling thread, may be empty
+        const std::atomic<bool>* cancel = nullptr;   ///< Stops the search once set
+        const char* checkpoint = nullptr;        ///< Resume from / save to this file (checkpoint.h)
+        double checkpointInterval = 60.0;        ///< Seconds between checkpoint writes
+        /// Receives every chunk this run finishes with its best hit (calls
+        /// are serialized), e.g. to cache per-chunk results; may be empty
+        std::function<void(uint64_t kBegin, uint64_t kEnd, const Result& best)> onChunk;
+    };
+
+    /**
+     * @struct Outcome
+     * @brief Result of search()
+     *
+     * A cancelled search still returns the best hit of every chunk that was
+     * finished; chunks are claimed in order, but finish out of order. With
+     * a checkpoint, searched and result include the resumed work.
+     */
+    struct Outcome {
+        Result result;
+        uint64_t searched = 0;   ///< k values in finished chunks
+        uint64_t total = 0;      ///< k values in the clamped range
+        uint64_t resumed = 0;    ///< k values already searched according to the checkpoint
+        bool cancelled = false;
+        bool checkpointFailed = false;   ///< A checkpoint write failed (the search went on)
+        const char* error = nullptr;     ///< Set if the search could not start
+        double seconds = 0;
+    };
+
+    /// Whether base is supported; unlike radix.h this includes zero mode in base 16
+    constexpr bool supported(int base) {
+        return base >= 2 && base <= 16;
+    }
+
+    /// Largest k worth testing: k*1 || k*2 must fit the pandigital length
+    uint64_t maxK(int base, bool zero = false);
+
+    // Kernels search k in [kBegin, kEnd] (inclusive, already clamped);
+    // enumerate() reports every hit with n >= 2 in ascending k
+    namespace scalar {
+        Result calc(int base, bool zero, uint64_t kBegin, uint64_t kEnd);
+        void enumerate(int base, bool zero, uint64_t kBegin, uint64_t kEnd, const HitFn& onHit);
+    }
+
+    /// Name of the kernel search() runs ("Scalar")
+    const char* kernelName();
+
+    /**
+     * @brief Searches k in [kBegin, kEnd] on every worker of pool
+     *
+     * kEnd is clamped to maxK(base, zero). The result is identical for any
+     * pool size and chunk size unless the search is cancelled. With
+     * options.checkpoint the search continues from that file if it exists
+     * and belongs to the same search, saves it every checkpointInterval
+     * seconds and once more at the end; a resumed search returns the same
+     * result as an uninterrupted one.
+     */
+    Outcome search(parallel::ThreadPool& pool, int base, bool zero,
+                   uint64_t kBegin, uint64_t kEnd, const Options& options = {});
+
+    /**
+     * @brief Every hit with k in [kBegin, kEnd], found on every worker of pool
+     * @return Hits ordered with greater(), best first; identical for any
+     *         pool size and chunk size
+     *
+     * kEnd is clamped to maxK(base, zero). Workers collect the hits of
+     * their chunks locally; hits are rare next to the k values searched.
+     * Once *cancel is set, workers stop claiming chunks and the hits found
+     * so far are returned (an incomplete answer the caller discards).
+     */
+    std::vector<Result> collect(parallel::ThreadPool& pool, int base, bool zero,
+                                uint64_t kBegin, uint64_t kEnd, uint64_t chunk = DEFAULT_CHUNK,
+                                const std::atomic<bool>* cancel = nullptr);
+}
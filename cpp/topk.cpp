@@ -0,0 +1,34 @@
+/**
+ * @file topk.cpp
+ * @brief TopK heap maintenance
+ */
+#include <algorithm>
+#include "topk.h"
+
+namespace impl::hits {
+    // With greater as the heap order the front is the worst hit kept
+    TopK::TopK(size_t capacity) : cap(capacity) {
+        heap.reserve(capacity);
+    }
+
+    void TopK::offer(const Hit& hit) {
+        if (heap.size() < cap) {
+            heap.push_back(hit);
+            std::push_heap(heap.begin(), heap.end(), greater);
+        } else if (cap > 0 && greater(hit, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            heap.back() = hit;
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+    }
+
+    void TopK::merge(const TopK& other) {
+        for (const Hit& h : other.heap) offer(h);
+    }
+
+    std::vector<Hit> TopK::sorted() const {
+        std::vector<Hit> out = heap;
+        std::sort(out.begin(), out.end(), greater);
+        return out;
+    }
+}
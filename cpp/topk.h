@@ -0,0 +1,52 @@
+/**
+ * @file topk.h
+ * @brief Bounded heap keeping the K best hits
+ *
+ * Kernels first compare whole vectors against threshold() and only offer
+ * lanes that pass, so the heap is touched a handful of times per range
+ * even for K in the hundreds. The heap storage is reserved once in the
+ * constructor (K * 12 bytes, cache-resident for the sizes in use).
+ */
+
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <vector>
+#include "hits.h"
+
+namespace impl::hits {
+    /**
+     * @class TopK
+     * @brief Fixed-capacity min-heap over hits::greater
+     *
+     * The root is the worst hit kept, so a candidate only needs to beat
+     * the root once the heap is full.
+     */
+    class TopK {
+    public:
+        explicit TopK(size_t capacity);
+
+        size_t capacity() const { return cap; }
+        size_t size() const { return heap.size(); }
+
+        /// Lanes with a value below this cannot enter; 0 while not full
+        int threshold() const {
+            if (cap == 0) return INT_MAX;
+            return heap.size() < cap ? 0 : heap.front().value;
+        }
+
+        /// Inserts hit if it ranks among the best capacity() seen so far
+        void offer(const Hit& hit);
+
+        /// Offers every hit kept by other
+        void merge(const TopK& other);
+
+        /// Kept hits, best first
+        std::vector<Hit> sorted() const;
+
+    private:
+        std::vector<Hit> heap;
+        size_t cap;
+    };
+}
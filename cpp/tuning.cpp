@@ -0,0 +1,378 @@
+/**
+ * @file tuning.cpp
+ * @brief Candidate measurement and the profile file
+ *
+ * Compiled without ISA flags: candidates run through the dispatch table,
+ * and only engines the host supports are measured.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+#include "tuning.h"
+#include "cpu_features.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace impl::tuning {
+    namespace {
+        constexpr int MAX_K = 9999;
+        constexpr int UNROLL_DEPTHS[] = {1, 2, 4};
+        constexpr int CHUNKS[] = {256, 512, 1024, 2048, 4096, 8192};
+
+        bool validUnroll(int unroll) {
+            return std::find(std::begin(UNROLL_DEPTHS), std::end(UNROLL_DEPTHS), unroll)
+                   != std::end(UNROLL_DEPTHS);
+        }
+
+        bool same(const CalcResult& a, const CalcResult& b) {
+            return a.maxVal == b.maxVal && a.bestK == b.bestK && a.bestN == b.bestN;
+        }
+
+        // Median per-call time of fn; result receives its return value
+        template <typename Fn>
+        double medianNs(const Fn& fn, const Options& options, CalcResult& result) {
+            using Clock = std::chrono::steady_clock;
+            auto elapsedNs = [](Clock::time_point start) {
+                return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            };
+
+            result = fn();   // warmup: page in tables, wake the pool
+            int calls = 1;
+            for (;;) {
+                auto start = Clock::now();
+                for (int i = 0; i < calls; ++i) result = fn();
+                if (elapsedNs(start) >= options.minSampleUs * 1000.0 || calls >= (1 << 20)) break;
+                calls *= 2;
+            }
+
+            std::vector<double> samples;
+            for (int s = 0; s < std::max(options.samples, 1); ++s) {
+                auto start = Clock::now();
+                for (int i = 0; i < calls; ++i) result = fn();
+                samples.push_back(elapsedNs(start) / calls);
+            }
+            auto mid = samples.begin() + samples.size() / 2;
+            std::nth_element(samples.begin(), mid, samples.end());
+            return *mid;
+        }
+
+        std::string trim(const std::string& s) {
+            const char* space = " \t\r\n";
+            size_t first = s.find_first_not_of(space);
+            if (first == std::string::npos) return "";
+            return s.substr(first, s.find_last_not_of(space) - first + 1);
+        }
+
+        bool parseInt(const std::string& s, long long& out) {
+            char* end = nullptr;
+            out = std::strtoll(s.c_str(), &end, 10);
+            return !s.empty() && *end == '\0';
+        }
+
+        // Applies one "key = value" line to entries; false if it is malformed
+        bool parseLine(const std::string& line, std::vector<Profile>& entries) {
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) return false;
+            const std::string key = trim(line.substr(0, eq));
+            const std::string value = trim(line.substr(eq + 1));
+
+            if (key == "host") {
+                entries.push_back(Profile{});
+                entries.back().host = value;
+                return true;
+            }
+            if (entries.empty()) return false;
+            Profile& p = entries.back();
+            long long v = 0;
+            if (key == "engine") {
+                p.engine = value;
+            } else if (key == "unroll" && parseInt(value, v)) {
+                p.unroll = static_cast<int>(v);
+            } else if (key == "chunk" && parseInt(value, v) && v > 0 && v <= MAX_K) {
+                p.chunk = static_cast<int>(v);
+            } else if (key == "threads" && parseInt(value, v) && v > 0) {
+                p.threads = static_cast<unsigned>(v);
+            } else if (key == "ns") {
+                char* end = nullptr;
+                p.ns = std::strtod(value.c_str(), &end);
+                if (value.empty() || *end != '\0') return false;
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        // Every entry of the file; false on a malformed line
+        bool parse(std::istream& in, std::vector<Profile>& entries) {
+            std::string line;
+            while (std::getline(in, line)) {
+                line = trim(line);
+                if (line.empty() || line[0] == '#') continue;
+                if (!parseLine(line, entries)) return false;
+            }
+            return true;
+        }
+
+        // The well-formed entries of a damaged file: a block with a
+        // malformed line (or without an engine) is dropped, the others kept
+        std::vector<Profile> salvage(std::istream& in) {
+            std::vector<Profile> entries;
+            std::vector<bool> damaged;
+            std::string line;
+            while (std::getline(in, line)) {
+                line = trim(line);
+                if (line.empty() || line[0] == '#') continue;
+                const size_t before = entries.size();
+                const bool ok = parseLine(line, entries);
+                if (entries.size() > before) damaged.push_back(false);
+                if (!ok && !entries.empty()) damaged.back() = true;
+            }
+            std::vector<Profile> kept;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                if (!damaged[i] && !entries[i].engine.empty()) kept.push_back(entries[i]);
+            }
+            return kept;
+        }
+
+        /**
+         * @class FileLock
+         * @brief Exclusive advisory lock on a side file, held for the object's lifetime
+         *
+         * Serializes the read-modify-write of save() between processes,
+         * also on other hosts sharing the file (fcntl locks work over NFS).
+         */
+        class FileLock {
+        public:
+            explicit FileLock(const std::string& path) {
+#if defined(_WIN32)
+                handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                     FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                     OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (handle == INVALID_HANDLE_VALUE) return;
+                OVERLAPPED region = {};
+                locked = LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &region) != 0;
+#else
+                fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                if (fd < 0) return;
+                struct flock region = {};
+                region.l_type = F_WRLCK;
+                region.l_whence = SEEK_SET;
+                while (!(locked = fcntl(fd, F_SETLKW, &region) == 0) && errno == EINTR) {}
+#endif
+            }
+
+            ~FileLock() {
+#if defined(_WIN32)
+                if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);   // Releases the lock
+#else
+                if (fd >= 0) close(fd);   // Releases the lock
+#endif
+            }
+
+            FileLock(const FileLock&) = delete;
+            FileLock& operator=(const FileLock&) = delete;
+
+            bool ok() const { return locked; }
+
+        private:
+#if defined(_WIN32)
+            HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+            int fd = -1;
+#endif
+            bool locked = false;
+        };
+
+        // Temporary file name unique to this process on this machine
+        std::string tempName(const std::string& path) {
+#if defined(_WIN32)
+            const char* machine = std::getenv("COMPUTERNAME");
+            const std::string name = machine ? machine : "host";
+            const long pid = static_cast<long>(_getpid());
+#else
+            char machine[256] = {};
+            gethostname(machine, sizeof(machine) - 1);
+            const std::string name = *machine ? machine : "host";
+            const long pid = static_cast<long>(getpid());
+#endif
+            return path + ".tmp." + name + "." + std::to_string(pid);
+        }
+    }
+
+    std::string hostKey() {
+        return cpu::brand() + " | " + cpu::describe(cpu::features());
+    }
+
+    std::string defaultPath() {
+        if (const char* path = std::getenv("PANDIGITAL_PROFILE"); path && *path) return path;
+#ifdef _WIN32
+        const char* home = std::getenv("USERPROFILE");
+#else
+        const char* home = std::getenv("HOME");
+#endif
+        if (home && *home) return std::string(home) + "/.pandigital-tuning";
+        return "pandigital-tuning";
+    }
+
+    Profile tune(parallel::ThreadPool& pool, const Options& options) {
+        auto log = [&](const std::string& line) {
+            if (options.log) options.log(line);
+        };
+        auto describe = [](const dispatch::Engine& e, int unroll) {
+            return std::string(e.id) + (e.calcUnrolled ? " unroll " + std::to_string(unroll) : "");
+        };
+
+        const CalcResult reference = dispatch::find("simple")->calc();
+        const cpu::CpuFeatures& features = cpu::features();
+
+        // 1. Engine and unroll depth, single-threaded
+        const dispatch::Engine* bestEngine = nullptr;
+        int bestUnroll = dispatch::DEFAULT_UNROLL;
+        double bestNs = 0;
+        size_t count = 0;
+        const dispatch::Engine* engines = dispatch::engines(count);
+        for (size_t i = 0; i < count; ++i) {
+            const dispatch::Engine& e = engines[i];
+            if (!e.supported(features)) continue;
+            for (int unroll : UNROLL_DEPTHS) {
+                if (!e.calcUnrolled && unroll != dispatch::DEFAULT_UNROLL) continue;
+                CalcResult r;
+                double ns = e.calcUnrolled
+                    ? medianNs([&] { return e.calcUnrolled(1, MAX_K, unroll); }, options, r)
+                    : medianNs([&] { return e.calcRange(1, MAX_K); }, options, r);
+                if (!same(r, reference)) {
+                    log(describe(e, unroll) + ": wrong result, skipped");
+                    continue;
+                }
+                std::ostringstream line;
+                line << describe(e, unroll) << ": " << static_cast<long long>(ns) << " ns";
+                log(line.str());
+                if (!bestEngine || ns < bestNs) {
+                    bestEngine = &e;
+                    bestUnroll = unroll;
+                    bestNs = ns;
+                }
+            }
+        }
+        if (!bestEngine) bestEngine = dispatch::find("simple");
+
+        // 2. Chunk size of the winner on the pool
+        const dispatch::Engine& e = *bestEngine;
+        const int unroll = bestUnroll;
+        parallel::RangeKernel kernel = [&e, unroll](int lo, int hi) {
+            return e.calcUnrolled ? e.calcUnrolled(lo, hi, unroll) : e.calcRange(lo, hi);
+        };
+        Profile profile;
+        profile.host = hostKey();
+        profile.engine = e.id;
+        profile.unroll = unroll;
+        profile.threads = pool.size();
+        for (int chunk : CHUNKS) {
+            CalcResult r;
+            double ns = medianNs([&] { return parallel::calc(pool, kernel, 1, MAX_K, chunk); }, options, r);
+            if (!same(r, reference)) {
+                log("chunk " + std::to_string(chunk) + ": wrong result, skipped");
+                continue;
+            }
+            std::ostringstream line;
+            line << "chunk " << chunk << " on " << pool.size() << " threads: "
+                 << static_cast<long long>(ns) << " ns";
+            log(line.str());
+            if (profile.ns == 0 || ns < profile.ns) {
+                profile.chunk = chunk;
+                profile.ns = ns;
+            }
+        }
+        return profile;
+    }
+
+    Load load(const std::string& path, const std::string& host, Profile& profile) {
+        std::ifstream in(path);
+        if (!in) return Load::Missing;
+        std::vector<Profile> entries;
+        if (!parse(in, entries)) return Load::Corrupt;
+        for (const auto& p : entries) {
+            if (p.host == host) {
+                if (p.engine.empty()) return Load::Corrupt;
+                profile = p;
+                return Load::Ok;
+            }
+        }
+        return Load::NoEntry;
+    }
+
+    bool save(const std::string& path, const Profile& profile) {
+        // Hosts sharing the file take turns, so no one's new entry is lost
+        FileLock lock(path + ".lock");
+        if (!lock.ok()) return false;
+
+        // Keep the other hosts' entries, also the intact ones of a damaged file
+        std::vector<Profile> entries;
+        {
+            std::ifstream in(path);
+            if (in && !parse(in, entries)) {
+                in.clear();
+                in.seekg(0);
+                entries = salvage(in);
+            }
+        }
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&](const Profile& p) { return p.host == profile.host; });
+        if (it != entries.end()) {
+            *it = profile;
+        } else {
+            entries.push_back(profile);
+        }
+
+        const std::string temp = tempName(path);
+        {
+            std::ofstream out(temp, std::ios::trunc);
+            if (!out) return false;
+            out << "# pandigital tuning profile, one block per host (see tuning.h)\n";
+            for (const auto& p : entries) {
+                out << "\nhost = " << p.host << '\n'
+                    << "engine = " << p.engine << '\n'
+                    << "unroll = " << p.unroll << '\n'
+                    << "chunk = " << p.chunk << '\n'
+                    << "threads = " << p.threads << '\n'
+                    << "ns = " << p.ns << '\n';
+            }
+            out.flush();
+            if (!out) {
+                out.close();
+                std::remove(temp.c_str());
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool apply(const Profile& profile) {
+        const dispatch::Engine* e = dispatch::find(profile.engine.c_str());
+        if (!e || !e->supported(cpu::features())) return false;
+        if (!validUnroll(profile.unroll) || profile.chunk <= 0) return false;
+        dispatch::select(*e, profile.unroll);
+        parallel::setDefaultChunk(profile.chunk);
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file tuning.h
+ * @brief Per-host autotuner and persisted tuning profiles
+ *
+ * The fastest configuration depends on the microarchitecture: whether the
+ * 16-lane AVX-512 kernels beat the 8-lane AVX2 ones (clock offsets, gather
+ * throughput), how many independent batches per loop step hide the
+ * multiply and gather latency, and which chunk size balances claiming
+ * overhead against load balance on the core count at hand. tune()
+ * measures the candidates on the running host:
+ *   1. every supported dispatch engine, single-threaded over k = 1..9999,
+ *      at unroll depths 1, 2 and 4 where the kernel takes one;
+ *   2. the winner on the given pool at chunk sizes 256..8192.
+ * Candidates whose result differs from the simple engine's are dropped.
+ *
+ * Profiles are keyed by CPU brand string and detected features, so one
+ * file can serve a heterogeneous fleet (e.g. in a shared home directory):
+ * every host reads and replaces only its own entry, under an advisory
+ * lock on "<path>.lock" so concurrent first runs do not lose each other's
+ * entries. The file is plain text
+ * with one block per host, each starting at its host line:
+ *
+ *   host = Intel(R) Xeon(R) Gold 6338 CPU @ 2.00GHz | avx2 fma avx512f ...
+ *   engine = avx512
+ *   unroll = 4
+ *   chunk = 1024
+ *   threads = 64
+ *   ns = 5123.4
+ *
+ * Lines starting with '#' are comments.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include "dispatch.h"
+#include "parallel.h"
+
+namespace impl::tuning {
+    /**
+     * @struct Profile
+     * @brief Fastest configuration measured on one host
+     */
+    struct Profile {
+        std::string host;                          ///< hostKey() of the host it was measured on
+        std::string engine;                        ///< Dispatch table id
+        int unroll = dispatch::DEFAULT_UNROLL;     ///< Batches per loop step (unrollable engines)
+        int chunk = parallel::DEFAULT_CHUNK;       ///< k values claimed per step by the parallel driver
+        unsigned threads = 1;                      ///< Pool size the chunk was measured with
+        double ns = 0;                             ///< Median multi-threaded time of a full search
+    };
+
+    /**
+     * @struct Options
+     * @brief Measurement settings of tune()
+     */
+    struct Options {
+        int samples = 15;                  ///< Timed samples per candidate (median is used)
+        double minSampleUs = 200.0;        ///< Each sample repeats calls until it lasts this long
+        std::function<void(const std::string&)> log;   ///< One line per candidate, may be empty
+    };
+
+    /// Profile key of the running host: "<cpu brand> | <features>"
+    std::string hostKey();
+
+    /// $PANDIGITAL_PROFILE, else ~/.pandigital-tuning, else ./pandigital-tuning
+    std::string defaultPath();
+
+    /// Benchmarks the candidates on this host and returns the fastest
+    Profile tune(parallel::ThreadPool& pool, const Options& options = {});
+
+    enum class Load {
+        Ok,         ///< profile holds the host's entry
+        Missing,    ///< No file at path
+        NoEntry,    ///< File has no entry for the host
+        Corrupt,    ///< Unparsable line or value
+    };
+
+    /// Reads the entry of host from path
+    Load load(const std::string& path, const std::string& host, Profile& profile);
+
+    /**
+     * @brief Stores profile under profile.host, keeping other hosts' entries
+     *
+     * Holds an exclusive lock on path + ".lock" while it reads, rewrites
+     * and renames a temporary file (named after the machine and process)
+     * over path. A damaged file keeps its well-formed entries. false on
+     * I/O errors or if the lock cannot be taken.
+     */
+    bool save(const std::string& path, const Profile& profile);
+
+    /**
+     * @brief Makes profile the configuration of this process
+     * @return false if the engine is unknown or unsupported on this CPU,
+     *         or the unroll depth or chunk is invalid; nothing is changed then
+     */
+    bool apply(const Profile& profile);
+}